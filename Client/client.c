@@ -3,17 +3,63 @@
 #include <string.h>
 #include <unistd.h>
 #include <arpa/inet.h>
-#include <pthread.h>
-#include <semaphore.h>
 #include <termios.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
 #include "client.h"
+#include "latency.h"
+#include "../Game_logic/game_hash.h"
+#include "../Game_logic/game_lockstep.h"
+#include "../Game_logic/game_render.h"
+#include "../Protocol/protocol.h"
+#include "../Protocol/shm_channel.h"
 
 #define PORT 45544
 #define BUFFER_SIZE 1024
 
-int sock; // Socket zdieľaný medzi vláknami
-pthread_mutex_t send_mutex = PTHREAD_MUTEX_INITIALIZER; // Mutex pre odosielanie správ
+int sock = -1; // Spojenie so serverom
 int game_active = 0; // Indikátor aktívnej hry
+char resume_token[RESUME_TOKEN_LENGTH + 1] = ""; // Token pre návrat do hry po výpadku
+unsigned int input_seq = 0; // Sekvencia posledného odoslaného vstupu
+unsigned int acked_input_seq = 0; // Sekvencia posledného vstupu potvrdeného serverom v rámci
+
+// UDP režim (SNAKE_TRANSPORT=udp): vstupy a rozdiely rámcov idú cez UDP, keyframe cez TCP
+int udp_sock = -1;
+static StreamReader reader;            // Správy zo servera (zachová sa aj počas menu)
+static char *keyframe = NULL;          // Posledná celá mapa prijatá cez TCP
+static size_t keyframe_capacity = 0;
+static unsigned int keyframe_tick = 0;
+static char *frame = NULL;             // Rámec zložený z UDP rozdielu alebo prečítaný zo zdieľanej pamäte
+static size_t frame_capacity = 0;
+static unsigned int rendered_tick = 0; // Starší rámec sa už nevykreslí
+static unsigned int recent_seqs[UDP_INPUT_REDUNDANCY];   // Posledné vstupy pre opakovanie v UDP
+static int recent_directions[UDP_INPUT_REDUNDANCY];
+static uint64_t recent_times[UDP_INPUT_REDUNDANCY];
+static int recent_count = 0;
+static char move_batch[BUFFER_SIZE];   // Vstupy z jedného čítania klávesnice, odošlú sa naraz
+static int move_batch_length = 0;
+static int udp_batched = 0;            // Počet nových vstupov v recent_* od posledného datagramu
+static ShmChannel *shm_channel = NULL; // Lokálny režim (SNAKE_TRANSPORT=shm)
+static size_t shm_frame_capacity = 0;  // Kapacita rámca kanála overená pri namapovaní
+static volatile sig_atomic_t terminal_resized = 0; // SIGWINCH prišiel, rozmer treba poslať znova
+
+// Meranie oneskorenia (kláves 'l' alebo SNAKE_LATENCY=1 ho zobrazí pod mapou)
+static LatencyHistogram key_to_display;  // Od odoslania vstupu po vykreslenie rámca s jeho ack (hodiny klienta)
+static LatencyHistogram input_to_apply;  // Od prijatia vstupu serverom po ťah, ktorý ho použil
+static LatencyHistogram apply_to_sent;   // Od začiatku ťahu po odovzdanie rámca na odoslanie
+static LatencyHistogram received_to_rendered; // Od prijatia rámca klientom po vykreslenie
+static unsigned int measured_ack = 0;    // Posledný vstup, ktorého oneskorenie je už zapísané
+static int show_latency = 0;
+
+// Lockstep režim (SNAKE_TRANSPORT=lockstep): hru simuluje klient, server posiela len smer ťahov
+static int lockstep_mode = 0;
+static LockstepSession lockstep;
+static uint64_t predict_at_us = 0;     // Kedy predpovedať ďalší ťah (0 = čaká sa na server)
+static uint64_t step_interval_us = 0;  // Interval ťahov podľa posledného STEP
+static uint64_t lockstep_lead_us = 0;  // Odhad času tam a späť: o toľko klient predbieha server
+static int resync_requested = 0;       // Klient požiadal o nový STATE
 
 // Konfigurácia terminálu na raw mode
 void enable_raw_mode() {
@@ -31,78 +77,530 @@ void disable_raw_mode() {
     tcsetattr(STDIN_FILENO, TCSANOW, &term);
 }
 
-// Funkcia pre prijímanie správ od servera
-void *receive_updates(void *arg) {
+// Vytvorí nové spojenie so serverom. Vráti socket alebo -1 pri chybe.
+int connect_to_server() {
+    struct sockaddr_in serv_addr;
+
+    int new_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (new_sock < 0) {
+        perror("Socket creation failed");
+        return -1;
+    }
+
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT);
+
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        perror("Invalid address or address not supported");
+        close(new_sock);
+        return -1;
+    }
+
+    if (connect(new_sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        perror("Connection failed");
+        close(new_sock);
+        return -1;
+    }
+    return new_sock;
+}
+
+// Pošle serveru jeden príkazový riadok.
+static void send_command(const char *command) {
+    send(sock, command, strlen(command), MSG_NOSIGNAL);
+}
+
+// Ak je nastavené SNAKE_TRANSPORT=udp, shm alebo lockstep, požiada server o daný prenos.
+void request_transport() {
+    const char *transport = getenv("SNAKE_TRANSPORT");
+    if (!transport || (strcmp(transport, "udp") != 0 && strcmp(transport, "shm") != 0
+                       && strcmp(transport, "lockstep") != 0)) return;
+
+    char request[32];
+    snprintf(request, sizeof(request), "transport %s\n", transport);
+    send_command(request);
+}
+
+static void handle_resize_signal(int sig) {
+    (void)sig;
+    terminal_resized = 1;
+}
+
+// Pošle serveru rozmer terminálu, aby posielal len výrez mapy, ktorý sa zobrazí.
+// Mimo terminálu nepošle nič a server posiela celú mapu.
+void report_terminal_size() {
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) < 0 || size.ws_col == 0 || size.ws_row == 0) return;
+
+    char request[48];
+    snprintf(request, sizeof(request), "view %d %d\n", size.ws_col, size.ws_row);
+    send_command(request);
+}
+
+// Po výpadku spojenia sa pokúsi vrátiť do rozohranej hry pomocou resume tokenu.
+int reconnect_to_game() {
     char buffer[BUFFER_SIZE];
-    while (1) {
-        int bytes_read = read(sock, buffer, BUFFER_SIZE);
-        if (bytes_read <= 0) {
-            printf("Server odpojený\n");
-            close(sock); // Uzavretie socketu
-            pthread_exit(NULL); // Ukončenie vlákna
+    for (int attempt = 1; attempt <= RECONNECT_ATTEMPTS; attempt++) {
+        printf("Spojenie prerušené, pokus o návrat do hry %d/%d...\n", attempt, RECONNECT_ATTEMPTS);
+        int new_sock = connect_to_server();
+        if (new_sock >= 0) {
+            snprintf(buffer, BUFFER_SIZE, "resume %s\n", resume_token);
+            if (send(new_sock, buffer, strlen(buffer), MSG_NOSIGNAL) > 0) {
+                close(sock);
+                sock = new_sock;
+                request_transport(); // Server po návrate zabudol UDP adresu aj zdieľanú pamäť
+                report_terminal_size(); // Terminál sa mohol medzičasom zmeniť
+                return 0;
+            }
+            close(new_sock);
+        }
+        sleep(1);
+    }
+    return -1;
+}
+
+// Vypíše percentily oneskorení pod hernú mapu.
+static void print_latency_overlay() {
+    char line[160];
+    const LatencyHistogram *histograms[] = {&key_to_display, &input_to_apply, &apply_to_sent, &received_to_rendered};
+    for (size_t i = 0; i < sizeof(histograms) / sizeof(histograms[0]); i++) {
+        latency_format(histograms[i], line, sizeof(line));
+        printf("%s\n", line);
+    }
+    if (lockstep_mode) {
+        printf("lockstep: ťah %u, potvrdený %u, predstih %.1fms, rollbackov %llu (%llu ťahov znova), rozídení %llu\n",
+               lockstep.tick, lockstep.confirmed_tick, lockstep_lead_us / 1000.0,
+               (unsigned long long)lockstep.rollbacks, (unsigned long long)lockstep.resimulated_ticks,
+               (unsigned long long)lockstep.desyncs);
+    }
+}
+
+// Zapíše oneskorenie vykresleného rámca; vstup ack sa meria len pri prvom rámci, ktorý ho potvrdí.
+static void record_frame_latency(const FrameTiming *timing, unsigned int ack, uint64_t received_us) {
+    uint64_t rendered_us = latency_now_us();
+    latency_record(&received_to_rendered, rendered_us - received_us);
+
+    if (ack <= measured_ack || timing->input_time_us == 0) return;
+    measured_ack = ack;
+    if (rendered_us >= timing->input_time_us) {
+        latency_record(&key_to_display, rendered_us - timing->input_time_us);
+    }
+    latency_record(&input_to_apply, timing->input_wait_us);
+    latency_record(&apply_to_sent, timing->build_us);
+}
+
+// Vykreslí rámec, ak je novší ako naposledy vykreslený. received_us je čas prijatia rámca.
+static void render_frame(const char *data, int length, unsigned int tick, unsigned int ack,
+                         const FrameTiming *timing, uint64_t received_us) {
+    if (tick < rendered_tick) return;
+    rendered_tick = tick;
+    acked_input_seq = ack;
+    // Vymaž obrazovku a vykresli hernú mapu
+    printf("\033[H\033[J"); // Escape sekvencie na vyčistenie terminálu
+    printf("%.*s\n", length, data);
+    if (show_latency) {
+        print_latency_overlay();
+    }
+    fflush(stdout);
+    record_frame_latency(timing, ack, received_us);
+}
+
+// Zväčší buffer zloženého rámca aspoň na needed bajtov. Vráti 0 pri úspechu.
+static int reserve_frame(size_t needed) {
+    if (frame_capacity >= needed) return 0;
+    char *grown = realloc(frame, needed);
+    if (!grown) return -1;
+    frame = grown;
+    frame_capacity = needed;
+    return 0;
+}
+
+// Spracuje všetky čakajúce UDP rozdiely rámcov a zloží ich s posledným keyframe.
+static void receive_udp_updates() {
+    char datagram[UDP_MAX_DATAGRAM + 1];
+    ssize_t received;
+    while ((received = recv(udp_sock, datagram, UDP_MAX_DATAGRAM, MSG_DONTWAIT)) > 0) {
+        datagram[received] = '\0';
+        uint64_t received_us = latency_now_us();
+
+        unsigned int tick, base, ack;
+        FrameTiming timing;
+        int width, height;
+        const char *body;
+        if (parse_frame_delta_header(datagram, &tick, &base, &ack, &timing, &width, &height, &body) < 0) {
+            continue;
+        }
+
+        // Rozdiel voči inému keyframe alebo starší rámec sa zahodí, ďalší ťah príde o chvíľu
+        size_t needed = (size_t)(width + 1) * height + UDP_MAX_DATAGRAM;
+        if (base != keyframe_tick || !keyframe || tick <= rendered_tick || reserve_frame(needed) < 0) {
+            continue;
+        }
+        int length = apply_frame_delta(frame, frame_capacity, keyframe, width, height, body);
+        if (length >= 0) {
+            render_frame(frame, length, tick, ack, &timing, received_us);
+        }
+    }
+}
+
+// Otvorí UDP socket k serveru a ohlási mu svoju adresu.
+static void start_udp_transport(int port) {
+    if (udp_sock < 0) {
+        struct sockaddr_in serv_addr = {0};
+        serv_addr.sin_family = AF_INET;
+        serv_addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr);
+
+        int new_sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (new_sock < 0 || connect(new_sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+            perror("UDP socket failed");
+            if (new_sock >= 0) close(new_sock);
+            return;
+        }
+        udp_sock = new_sock;
+    }
+
+    // Kým server adresu nepozná, posiela celé rámce cez TCP; stratený HELLO teda nevadí
+    char hello[64];
+    int length = snprintf(hello, sizeof(hello), "HELLO %s", resume_token);
+    for (int i = 0; i < 3; i++) {
+        send(udp_sock, hello, (size_t)length, 0);
+    }
+}
+
+// Skontroluje nový rámec v zdieľanej pamäti servera (bez systémových volaní).
+static void receive_shm_update() {
+    if (reserve_frame(shm_frame_capacity) < 0) return;
+    unsigned int tick, ack;
+    FrameTiming timing;
+    int length = shm_channel_read(shm_channel, rendered_tick, &tick, &ack, &timing, frame, frame_capacity);
+    if (length > 0) {
+        render_frame(frame, length, tick, ack, &timing, latency_now_us());
+    }
+}
+
+// Namapuje kanál servera; po návrate do hry nahradí starý kanál novým.
+static void start_shm_transport(const char *name) {
+    size_t capacity;
+    ShmChannel *channel = shm_channel_open(name, &capacity);
+    if (!channel) {
+        perror("shm_open failed");
+        return;
+    }
+    shm_channel_close(shm_channel, shm_frame_capacity, NULL);
+    shm_channel = channel;
+    shm_frame_capacity = capacity;
+}
+
+// Odošle vstupy nazbierané z jedného čítania klávesnice: cez TCP jedným volaním,
+// v UDP režime jedným datagramom s poslednými vstupmi pre prípad straty.
+static void flush_moves() {
+    if (move_batch_length > 0) {
+        send(sock, move_batch, (size_t)move_batch_length, MSG_NOSIGNAL);
+        move_batch_length = 0;
+    }
+    if (udp_batched == 0) return;
+    udp_batched = 0;
+
+    char buffer[BUFFER_SIZE];
+    int length = snprintf(buffer, BUFFER_SIZE, "IN %s", resume_token);
+    for (int i = 0; i < recent_count; i++) {
+        // Server použije len vstupy novšie ako posledný potvrdený
+        if (recent_seqs[i] <= acked_input_seq) continue;
+        length += snprintf(buffer + length, BUFFER_SIZE - length, " %u %d %llu", recent_seqs[i],
+                           recent_directions[i], (unsigned long long)recent_times[i]);
+    }
+    send(udp_sock, buffer, (size_t)length, 0);
+}
+
+// Zaradí zmenu smeru do dávky. Lokálny klient ju zapíše rovno do fronty servera.
+// Vstup nesie čas odoslania, server ho vráti v rámci, ktorý ho potvrdí.
+static void queue_move(int direction) {
+    unsigned int seq = ++input_seq;
+    uint64_t sent_us = latency_now_us();
+    if (lockstep_mode) {
+        lockstep_input(&lockstep, direction); // Prejaví sa hneď v predpovedanom ťahu, server ho dostane cez TCP
+    }
+
+    // Pri plnej fronte v zdieľanej pamäti ide vstup cez TCP
+    if (shm_channel && shm_channel_push_input(shm_channel, seq, direction, sent_us) == 0) return;
+
+    if (udp_sock < 0) {
+        // Každý vstup nesie sekvenciu, server ju potvrdí v najbližšom rámci
+        if (move_batch_length > BUFFER_SIZE - 64) flush_moves();
+        move_batch_length += snprintf(move_batch + move_batch_length, BUFFER_SIZE - move_batch_length,
+                                      "move %u %d %llu\n", seq, direction, (unsigned long long)sent_us);
+        return;
+    }
+
+    // Vstup, ktorý by z posledných vstupov vypadol neodoslaný, sa najprv odošle
+    if (udp_batched == UDP_INPUT_REDUNDANCY) flush_moves();
+    if (recent_count == UDP_INPUT_REDUNDANCY) {
+        memmove(recent_seqs, recent_seqs + 1, sizeof(recent_seqs[0]) * (UDP_INPUT_REDUNDANCY - 1));
+        memmove(recent_directions, recent_directions + 1, sizeof(recent_directions[0]) * (UDP_INPUT_REDUNDANCY - 1));
+        memmove(recent_times, recent_times + 1, sizeof(recent_times[0]) * (UDP_INPUT_REDUNDANCY - 1));
+        recent_count--;
+    }
+    recent_seqs[recent_count] = seq;
+    recent_directions[recent_count] = direction;
+    recent_times[recent_count] = sent_us;
+    recent_count++;
+    udp_batched++;
+}
+
+// Vykreslí lokálne simulovanú hru. timing je NULL pri predpovedanom ťahu.
+static void render_lockstep(const FrameTiming *timing, uint64_t received_us) {
+    const Game *game = &lockstep.game;
+    if (reserve_frame((size_t)(game->width + 1) * game->height + GAME_RENDER_SUMMARY_MAX) < 0) return;
+    int length = draw_game_to_buffer(game, frame, frame_capacity);
+    FrameTiming none = {0};
+    render_frame(frame, length, lockstep.tick, acked_input_seq, timing ? timing : &none, received_us);
+}
+
+// Začne simuláciu zo stavu od servera (začiatok hry, koniec pauzy alebo nová synchronizácia).
+static void load_lockstep_state(const Message *message, uint64_t received_us) {
+    if (lockstep_load(&lockstep, message->payload, (size_t)message->length, message->tick) < 0
+        || (message->hash != 0 && game_hash(&lockstep.game) != message->hash)) {
+        lockstep.loaded = 0;
+        printf("Neplatný stav hry od servera.\n");
+        return;
+    }
+    resync_requested = 0;
+    predict_at_us = 0; // Ďalší ťah (aj po odpočte) ohlási server
+    rendered_tick = 0;
+    acked_input_seq = message->ack;
+    render_lockstep(NULL, received_us);
+}
+
+// Ťah potvrdený serverom: pri inom smere, ako klient predpovedal, nasleduje rollback.
+static void apply_lockstep_step(const Message *message, uint64_t received_us) {
+    char payload[32];
+    int direction;
+    long long interval_ms;
+    snprintf(payload, sizeof(payload), "%.*s", message->length, message->payload);
+    if (sscanf(payload, "%d %lld", &direction, &interval_ms) != 2) return;
+
+    // Čas tam a späť z ozveny vstupu, bez času, ktorý vstup na serveri čakal na ťah
+    if (message->ack > acked_input_seq && message->timing.input_time_us != 0) {
+        uint64_t server_us = (uint64_t)message->timing.input_wait_us + message->timing.build_us;
+        if (received_us > message->timing.input_time_us + server_us) {
+            uint64_t sample = received_us - message->timing.input_time_us - server_us;
+            lockstep_lead_us = lockstep_lead_us ? (lockstep_lead_us * 7 + sample) / 8 : sample;
+        }
+    }
+    acked_input_seq = message->ack;
+
+    int changed = lockstep_confirm(&lockstep, message->tick, direction, message->hash);
+    if (changed < 0) {
+        // Vynechaný ťah alebo rollback mimo kruhu snapshotov: simulácia pokračuje od nového stavu
+        if (!resync_requested) {
+            send_command("keyframe\n");
+            resync_requested = 1;
         }
-        buffer[bytes_read] = '\0';
+        predict_at_us = 0;
+        return;
+    }
+    if (!lockstep.loaded) return; // STATE ešte neprišiel
 
-        // Vymaž obrazovku a vykresli hernú mapu
-        printf("\033[H\033[J"); // Escape sekvencie na vyčistenie terminálu
-        printf("%s\n", buffer);
+    // Klient predbieha server o čas tam a späť, aby vstup stlačený pred predpovedaným ťahom
+    // stihol na server ten istý ťah (a predpoveď sa nemusela vracať)
+    step_interval_us = (uint64_t)interval_ms * 1000;
+    uint64_t lead = lockstep_lead_us < step_interval_us / 2 ? lockstep_lead_us : step_interval_us / 2;
+    predict_at_us = received_us + (lockstep.tick - lockstep.confirmed_tick + 1) * step_interval_us - lead;
+    if (changed) {
+        render_lockstep(&message->timing, received_us);
+    }
+}
 
-        // Kontrola ukončenia hry
-        if (strstr(buffer, "Hra skončila") != NULL) {
-            printf("%s\n", buffer);
-            printf("Hra skončila. Ukončujem aplikáciu...\n");
-            game_active = 0;
-            close(sock);
-            exit(0);
+// Predpovie ďalší ťah, ak nastal jeho čas a klient ešte nepredbehol server priveľmi.
+static void predict_lockstep() {
+    if (lockstep_predict(&lockstep)) {
+        render_lockstep(NULL, latency_now_us());
+        predict_at_us += step_interval_us;
+    } else {
+        predict_at_us = 0; // Ďalej až po potvrdení zo servera
+    }
+}
+
+// Uloží TCP rámec ako keyframe pre nasledujúce UDP rozdiely.
+static void store_keyframe(const Message *message) {
+    if (keyframe_capacity < (size_t)message->length + 1) {
+        char *grown = realloc(keyframe, (size_t)message->length + 1);
+        if (!grown) return;
+        keyframe = grown;
+        keyframe_capacity = (size_t)message->length + 1;
+    }
+    memcpy(keyframe, message->payload, (size_t)message->length);
+    keyframe[message->length] = '\0';
+    keyframe_tick = message->tick;
+}
+
+// Prečíta a spracuje správy zo servera. Vráti GAME_RUNNING, alebo dôvod konca slučky.
+static GameLoopResult receive_messages() {
+    int bytes_read = stream_reader_fill(&reader, sock);
+    uint64_t received_us = latency_now_us();
+    if (bytes_read < 0 && errno == EINTR) return GAME_RUNNING;
+    if (bytes_read <= 0) {
+        if (game_active && resume_token[0] != '\0' && reconnect_to_game() == 0) {
+            stream_reader_reset(&reader); // Rozpracovaná správa zo starého spojenia sa zahodí
+            lockstep.loaded = 0;          // Do nového STATE sa vykresľujú rámce servera
+            predict_at_us = 0;
+            return GAME_RUNNING;
         }
+        printf("Server odpojený\n");
+        return GAME_DISCONNECTED;
     }
-    return NULL;
+
+    Message message;
+    int status;
+    while ((status = stream_reader_next_message(&reader, &message)) == 1) {
+        switch (message.type) {
+            case MSG_TOKEN:
+                // Server na začiatku hry posiela token pre návrat po výpadku spojenia
+                snprintf(resume_token, sizeof(resume_token), "%.*s", message.length, message.payload);
+                break;
+            case MSG_FRAME:
+                if (lockstep_mode && lockstep.loaded) {
+                    break; // Rámec odoslaný ešte pred prechodom na lockstep
+                }
+                if (udp_sock >= 0) {
+                    // V UDP režime je každý TCP rámec keyframe pre nasledujúce rozdiely
+                    store_keyframe(&message);
+                }
+                render_frame(message.payload, message.length, message.tick, message.ack,
+                             &message.timing, received_us);
+                break;
+            case MSG_TRANSPORT: {
+                char transport[96];
+                int udp_port;
+                snprintf(transport, sizeof(transport), "%.*s", message.length, message.payload);
+                lockstep_mode = strcmp(transport, "lockstep") == 0;
+                lockstep.loaded = 0;
+                if (sscanf(transport, "udp %d", &udp_port) == 1) {
+                    start_udp_transport(udp_port);
+                } else if (strncmp(transport, "shm ", 4) == 0) {
+                    start_shm_transport(transport + 4);
+                }
+                break;
+            }
+            case MSG_STATE:
+                load_lockstep_state(&message, received_us);
+                break;
+            case MSG_STEP:
+                apply_lockstep_step(&message, received_us);
+                break;
+            case MSG_STATUS:
+                printf("%.*s\n", message.length, message.payload);
+                break;
+            case MSG_END:
+                printf("%.*s\n", message.length, message.payload);
+                game_active = 0;
+                return GAME_ENDED;
+            default:
+                break;
+        }
+    }
+    if (status < 0) {
+        printf("Neplatná správa od servera.\n");
+        stream_reader_reset(&reader);
+    }
+    return GAME_RUNNING;
 }
 
+// Spracuje všetky klávesy z jedného čítania; zmeny smeru odíde jednou dávkou.
+static GameLoopResult handle_keys() {
+    char keys[64];
+    ssize_t count = read(STDIN_FILENO, keys, sizeof(keys));
+    if (count < 0 && errno == EINTR) return GAME_RUNNING;
+    if (count <= 0) return GAME_PAUSED; // Koniec vstupu: hra ostane pozastavená
 
-// Funkcia pre odosielanie vstupov serveru
-void *send_updates(void *arg) {
+    GameLoopResult result = GAME_RUNNING;
+    for (ssize_t i = 0; i < count && result == GAME_RUNNING; i++) {
+        int direction = -1;
+        switch (keys[i]) {
+            case 'w': direction = 0; break;
+            case 'd': direction = 1; break;
+            case 's': direction = 2; break;
+            case 'a': direction = 3; break;
+            case 'q':
+                // Slučka beží ďalej, kým server nepošle záverečné skóre
+                flush_moves();
+                send_command("quit\n");
+                game_active = 0;
+                break;
+            case 'p':
+                flush_moves();
+                send_command("pause\n");
+                predict_at_us = 0; // Po pauze pošle server nový stav
+                result = GAME_PAUSED;
+                break;
+            case 'r':
+                // Odpočet pred pohybom riadi server, klient ďalej prijíma rámce
+                flush_moves();
+                send_command("resume\n");
+                break;
+            case 'l':
+                show_latency = !show_latency; // Prejaví sa od ďalšieho rámca
+                break;
+        }
+        if (direction != -1) {
+            queue_move(direction);
+        }
+    }
+    flush_moves();
+    return result;
+}
+
+GameLoopResult run_game_loop() {
     enable_raw_mode();
     printf("Ovládajte hada pomocou W (hore), A (vľavo), S (dole), D (vpravo).\n");
-    printf("Stlačte 'p' pre pozastavenie a 'q' pre ukončenie hry.\n");
+    printf("Stlačte 'p' pre pozastavenie, 'l' pre zobrazenie oneskorenia a 'q' pre ukončenie hry.\n");
 
-    char ch;
-    char buffer[BUFFER_SIZE];
-    while (read(STDIN_FILENO, &ch, 1) == 1) {
-        if (ch == 'q') {
-            snprintf(buffer, BUFFER_SIZE, "quit");
-            send(sock, buffer, strlen(buffer), 0);
-            game_active = 0;
-            break;
-        } else if (ch == 'p') {
-            snprintf(buffer, BUFFER_SIZE, "pause");
-            send(sock, buffer, strlen(buffer), 0);
+    GameLoopResult result = GAME_RUNNING;
+    while (result == GAME_RUNNING) {
+        if (terminal_resized) {
+            terminal_resized = 0;
+            report_terminal_size();
+        }
+
+        // Jedno čakanie na server, klávesnicu aj UDP; rámec zo zdieľanej pamäte sa kontroluje časovačom
+        struct pollfd fds[3] = {
+            {sock, POLLIN, 0},
+            {STDIN_FILENO, POLLIN, 0},
+            {udp_sock, POLLIN, 0} // Záporný deskriptor poll ignoruje
+        };
+        int timeout = shm_channel ? SHM_POLL_INTERVAL_MS : -1;
+        if (lockstep_mode && predict_at_us != 0) {
+            uint64_t now_us = latency_now_us();
+            int until_predict = now_us >= predict_at_us ? 0 : (int)((predict_at_us - now_us + 999) / 1000);
+            if (timeout < 0 || until_predict < timeout) timeout = until_predict;
+        }
+        int ready = poll(fds, 3, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue; // SIGWINCH
+            perror("poll failed");
+            result = GAME_DISCONNECTED;
             break;
-        } else if (ch == 'r') {
-            snprintf(buffer, BUFFER_SIZE, "resume");
-            send(sock, buffer, strlen(buffer), 0);
-            sleep(3); // Čakanie pred obnovením hry
-        } else {
-            int direction = -1;
-
-            switch (ch) {
-                case 'w': direction = 0; break;
-                case 'd': direction = 1; break;
-                case 's': direction = 2; break;
-                case 'a': direction = 3; break;
-            }
+        }
 
-            if (direction != -1) {
-                snprintf(buffer, BUFFER_SIZE, "%d", direction);
-                pthread_mutex_lock(&send_mutex);
-                send(sock, buffer, strlen(buffer), 0);
-                pthread_mutex_unlock(&send_mutex);
-            }
+        if (shm_channel) {
+            receive_shm_update();
+        }
+        if (lockstep_mode && predict_at_us != 0 && latency_now_us() >= predict_at_us) {
+            predict_lockstep();
+        }
+        if (fds[2].revents & POLLIN) {
+            receive_udp_updates();
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            result = receive_messages();
+        }
+        if (result == GAME_RUNNING && (fds[1].revents & (POLLIN | POLLHUP))) {
+            result = handle_keys();
         }
     }
 
     disable_raw_mode();
-    return NULL;
+    return result;
 }
 
 void start_new_game() {
@@ -123,16 +621,30 @@ void start_new_game() {
     scanf("%d", &world_type);
 
     char buffer[BUFFER_SIZE];
-    snprintf(buffer, BUFFER_SIZE, "%d %d %d %d %d", width, height, game_mode, time_limit, world_type);
-    pthread_mutex_lock(&send_mutex);
-    send(sock, buffer, strlen(buffer), 0);
-    pthread_mutex_unlock(&send_mutex);
+    snprintf(buffer, BUFFER_SIZE, "%d %d %d %d %d\n", width, height, game_mode, time_limit, world_type);
+    send_command(buffer);
+    request_transport();
+    report_terminal_size();
     game_active = 1;
 }
 
+// Spustí hernú slučku a vyhodnotí, prečo skončila. Vráti 1, ak sa má aplikácia ukončiť.
+static int play() {
+    GameLoopResult result = run_game_loop();
+    if (result == GAME_ENDED) {
+        printf("Hra skončila. Ukončujem aplikáciu...\n");
+        return 1;
+    }
+    if (result == GAME_DISCONNECTED) {
+        game_active = 0;
+        return 1;
+    }
+    printf("Vraciame sa do hlavného menu...\n");
+    return 0;
+}
+
 void main_menu() {
     int choice;
-    pthread_t send_thread;
 
     while (1) {
         printf("\n--- Hlavné Menu ---\n");
@@ -140,42 +652,27 @@ void main_menu() {
         printf("2. Pokračovať v hre\n");
         printf("3. Skonči\n");
         printf("Vaša voľba: ");
-        scanf("%d", &choice);
+        if (scanf("%d", &choice) != 1) {
+            return; // Koniec vstupu
+        }
 
         switch (choice) {
             case 1:
                 start_new_game();
-                pthread_create(&send_thread, NULL, send_updates, NULL);
-                pthread_join(send_thread, NULL);
-
-                // Po skončení hry sa vráťte do hlavného menu
-                if (!game_active) {
-                    printf("Vraciame sa do hlavného menu...\n");
-                }
+                if (play()) return;
                 break;
             case 2:
                 if (game_active) {
                     printf("Obnovujem hru...\n");
-                    char buffer[BUFFER_SIZE];
-                    snprintf(buffer, BUFFER_SIZE, "resume");
-                    pthread_mutex_lock(&send_mutex);
-                    send(sock, buffer, strlen(buffer), 0);
-                    pthread_mutex_unlock(&send_mutex);
-
-                    pthread_t resume_thread;
-                    pthread_create(&resume_thread, NULL, send_updates, NULL);
-                    pthread_join(resume_thread, NULL);
+                    send_command("resume\n");
+                    if (play()) return;
                 } else {
                     printf("Nie je aktívna žiadna hra na pokračovanie.\n");
                 }
                 break;
             case 3:
                 printf("Ukončujem aplikáciu...\n");
-
-                // Uvoľnenie zdrojov
-                pthread_mutex_destroy(&send_mutex);
-                close(sock);
-                exit(0);
+                return;
             default:
                 printf("Neplatná voľba. Skúste znova.\n");
         }
@@ -183,37 +680,49 @@ void main_menu() {
 }
 
 int main() {
-    struct sockaddr_in serv_addr;
-    pthread_t receive_thread;
-
     // Skúste sa pripojiť k serveru
-    sock = socket(AF_INET, SOCK_STREAM, 0);
+    sock = connect_to_server();
     if (sock < 0) {
-        perror("Socket creation failed");
         return -1;
     }
-
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(PORT);
-
-    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
-        perror("Invalid address or address not supported");
-        return -1;
-    }
-
-    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-        perror("Connection failed");
+    if (stream_reader_init(&reader) < 0) {
+        perror("malloc failed");
+        close(sock);
         return -1;
     }
 
     printf("Connected to server\n");
-    pthread_create(&receive_thread, NULL, receive_updates, NULL);
+
+    lockstep_init(&lockstep);
+    latency_init(&key_to_display, "kláves->obraz");
+    latency_init(&input_to_apply, "vstup->ťah");
+    latency_init(&apply_to_sent, "ťah->odoslanie");
+    latency_init(&received_to_rendered, "prijatie->obraz");
+    const char *latency_env = getenv("SNAKE_LATENCY");
+    show_latency = latency_env && strcmp(latency_env, "1") == 0;
+
+    // poll sa po signáli nikdy neobnovuje, takže SIGWINCH ho preruší aj s SA_RESTART
+    // a nový rozmer sa pošle hneď; čítanie menu (scanf) sa obnoví
+    struct sigaction resize_action = {0};
+    resize_action.sa_handler = handle_resize_signal;
+    resize_action.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &resize_action, NULL);
 
     main_menu();
 
-    pthread_cancel(receive_thread);
-    pthread_join(receive_thread, NULL);
-    pthread_mutex_destroy(&send_mutex);
+    // Súhrn oneskorení za celý beh
+    latency_dump(&key_to_display, stderr);
+    latency_dump(&input_to_apply, stderr);
+    latency_dump(&apply_to_sent, stderr);
+    latency_dump(&received_to_rendered, stderr);
+
+    // Uvoľnenie zdrojov
+    stream_reader_free(&reader);
+    shm_channel_close(shm_channel, shm_frame_capacity, NULL);
+    if (udp_sock >= 0) close(udp_sock);
+    lockstep_free(&lockstep);
+    free(keyframe);
+    free(frame);
     close(sock);
     return 0;
-}
\ No newline at end of file
+}
@@ -1,22 +1,38 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
-#include <pthread.h>
-
 // Makrá
 #define PORT 45544
 #define BUFFER_SIZE 1024
+#define RESUME_TOKEN_LENGTH 32
+#define RECONNECT_ATTEMPTS 5 // Počet pokusov o opätovné pripojenie po výpadku spojenia
+
+// Prečo skončila herná slučka
+typedef enum {
+    GAME_RUNNING = 0,  // Slučka beží ďalej
+    GAME_PAUSED,       // Hráč hru pozastavil, návrat do menu
+    GAME_ENDED,        // Server poslal záverečné skóre
+    GAME_DISCONNECTED  // Spojenie sa stratilo a návrat do hry sa nepodaril
+} GameLoopResult;
 
-// Globálne premenné
-extern int sock; // Socket zdieľaný medzi vláknami
-extern pthread_mutex_t send_mutex; // Mutex pre odosielanie správ
+// Globálne premenné (klient beží v jednom vlákne)
+extern int sock; // Spojenie so serverom
 extern int game_active; // Indikátor aktívnej hry
+extern char resume_token[RESUME_TOKEN_LENGTH + 1]; // Token pre návrat do hry po výpadku
+extern unsigned int input_seq; // Sekvencia posledného odoslaného vstupu
+extern unsigned int acked_input_seq; // Sekvencia posledného vstupu potvrdeného serverom
+extern int udp_sock; // UDP socket v režime SNAKE_TRANSPORT=udp, inak -1
 
 // Funkcie
 void enable_raw_mode();
 void disable_raw_mode();
-void *receive_updates(void *arg);
-void *send_updates(void *arg);
+int connect_to_server();
+int reconnect_to_game();
+void request_transport();
+void report_terminal_size();
+// Jedna slučka nad socketom servera, klávesnicou a UDP (rámce zo zdieľanej pamäte podľa
+// časovača poll). Rámce vykresľuje hneď po prijatí, klávesy z jedného čítania posiela dávkou.
+GameLoopResult run_game_loop();
 void start_new_game();
 void main_menu();
 
@@ -0,0 +1,71 @@
+#include "latency.h"
+#include <string.h>
+#include <time.h>
+
+uint64_t latency_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static int latency_bucket(uint32_t us) {
+    int bucket = 0;
+    while (us > 1 && bucket < LATENCY_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void latency_init(LatencyHistogram *histogram, const char *name) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->name = name;
+}
+
+void latency_record(LatencyHistogram *histogram, uint64_t us) {
+    uint32_t value = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+    int bucket = latency_bucket(value);
+
+    // Najstaršie meranie vypadne z okna
+    if (histogram->window_count == LATENCY_WINDOW) {
+        histogram->window_buckets[latency_bucket(histogram->window[histogram->window_next])]--;
+    } else {
+        histogram->window_count++;
+    }
+    histogram->window[histogram->window_next] = value;
+    histogram->window_next = (histogram->window_next + 1) % LATENCY_WINDOW;
+    histogram->window_buckets[bucket]++;
+
+    histogram->total_buckets[bucket]++;
+    histogram->total_count++;
+    if (value > histogram->max_us) histogram->max_us = value;
+}
+
+uint32_t latency_percentile(const LatencyHistogram *histogram, int percent) {
+    if (histogram->window_count == 0) return 0;
+    int rank = (histogram->window_count * percent + 99) / 100;
+    int seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        seen += (int)histogram->window_buckets[bucket];
+        if (seen >= rank) return (uint32_t)2 << bucket;
+    }
+    return (uint32_t)2 << (LATENCY_BUCKETS - 1);
+}
+
+int latency_format(const LatencyHistogram *histogram, char *out, size_t cap) {
+    return snprintf(out, cap, "%-18s n=%-4d p50<%.1fms p90<%.1fms p99<%.1fms max %.1fms",
+                    histogram->name, histogram->window_count,
+                    latency_percentile(histogram, 50) / 1000.0, latency_percentile(histogram, 90) / 1000.0,
+                    latency_percentile(histogram, 99) / 1000.0, histogram->max_us / 1000.0);
+}
+
+void latency_dump(const LatencyHistogram *histogram, FILE *out) {
+    if (histogram->total_count == 0) return;
+    fprintf(out, "%s (%llu meraní, max %.3f ms):\n", histogram->name,
+            (unsigned long long)histogram->total_count, histogram->max_us / 1000.0);
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        if (histogram->total_buckets[bucket] == 0) continue;
+        fprintf(out, "  < %10.3f ms  %8llu\n", ((uint64_t)2 << bucket) / 1000.0,
+                (unsigned long long)histogram->total_buckets[bucket]);
+    }
+}
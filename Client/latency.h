@@ -0,0 +1,40 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Histogramy oneskorení v mikrosekundách s košmi po mocninách dvoch. Percentily sa počítajú
+// z kĺzavého okna posledných LATENCY_WINDOW meraní, súhrn za celý beh sa vypíše pri skončení.
+
+#define LATENCY_BUCKETS 24   // Kôš b má merania z [2^b, 2^(b+1)) us, posledný aj všetky dlhšie
+#define LATENCY_WINDOW 256   // Počet posledných meraní pre percentily
+
+typedef struct {
+    const char *name;
+    uint32_t window[LATENCY_WINDOW];  // Posledné merania (kruh)
+    int window_count;
+    int window_next;
+    uint32_t window_buckets[LATENCY_BUCKETS];
+    uint64_t total_buckets[LATENCY_BUCKETS];
+    uint64_t total_count;
+    uint32_t max_us;
+} LatencyHistogram;
+
+// Monotónny čas v mikrosekundách (rovnaké hodiny ako server na tom istom stroji).
+uint64_t latency_now_us(void);
+
+void latency_init(LatencyHistogram *histogram, const char *name);
+
+void latency_record(LatencyHistogram *histogram, uint64_t us);
+
+// Horná hranica koša, v ktorom leží daný percentil kĺzavého okna (0, ak okno je prázdne).
+uint32_t latency_percentile(const LatencyHistogram *histogram, int percent);
+
+// Jeden riadok prehľadu (percentily okna) pre ladiace zobrazenie. Vráti dĺžku.
+int latency_format(const LatencyHistogram *histogram, char *out, size_t cap);
+
+// Vypíše celý histogram za beh (nič, ak nie sú merania).
+void latency_dump(const LatencyHistogram *histogram, FILE *out);
+
+#endif // LATENCY_H
@@ -0,0 +1,22 @@
+#include "game_hash.h"
+#include "game_items.h"
+
+uint64_t game_board_hash_compute(const Game *game) {
+    uint64_t hash = 0;
+    for (int i = 0; i + 1 < game->snake.length; i++) {
+        hash ^= game_hash_edge(game, game->snake.body[i], game->snake.body[i + 1]);
+    }
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            int cell = y * game->width + x;
+            if (game->obstacles[y][x] == 1) hash ^= game_hash_key(GAME_HASH_OBSTACLE, cell);
+            int item = game->cells[cell] & CELL_ITEM_MASK;
+            if (item != ITEM_NONE) hash ^= game_hash_key(GAME_HASH_ITEM + item, cell);
+        }
+    }
+    return hash;
+}
+
+void game_hash_rebuild(Game *game) {
+    game->board_hash = game_board_hash_compute(game);
+}
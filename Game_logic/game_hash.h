@@ -0,0 +1,64 @@
+#ifndef GAME_HASH_H
+#define GAME_HASH_H
+
+#include <stdint.h>
+#include "game_logic.h"
+
+// Zobristov hash stavu hry: XOR kľúčov všetkých článkov hada, predmetov a prekážok
+// (game->board_hash) a pri čítaní aj hlavy, smeru a príznaku živého hada. Kľúč políčka
+// sa nečíta z tabuľky, ale vypočíta sa zmiešaním (splitmix64), takže funguje pre každý rozmer.
+//
+// Článok sa hashuje ako hrana: políčko spolu so smerom k ďalšiemu článku (k chvostu). Hlava
+// a množina hrán tak určujú celé telo v poradí, rovnaký hash znamená rovnaký stav (až na
+// 64-bitové kolízie). board_hash sa mení v O(1): move_snake pridá hranu novej hlavy a odoberie
+// hranu k starému chvostu, predĺženie a skrátenie pridá alebo odoberie hranu na konci tela,
+// položenie alebo zobratie predmetu pridá alebo odoberie jeho kľúč (game_items.c).
+
+#define GAME_HASH_BODY 0      // Článok bez susedného nasledovníka (len poškodené telo)
+#define GAME_HASH_HEAD 1      // Hlava hada na políčku
+#define GAME_HASH_OBSTACLE 2  // Prekážka na políčku
+#define GAME_HASH_ITEM 3      // + ITEM_* (4 - 6): predmet na políčku
+#define GAME_HASH_DIRECTION 7 // Smer hada (namiesto políčka)
+#define GAME_HASH_DEAD 8      // Had je mŕtvy
+#define GAME_HASH_EDGE 9      // + smer (9 - 12): článok na políčku a smer k ďalšiemu článku
+
+static inline uint64_t game_hash_key(int kind, int cell) {
+    uint64_t z = ((uint64_t)(uint32_t)cell << 4 | (uint64_t)kind) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Kľúč článku na políčku from, za ktorým nasleduje článok to. Smer je ako v move_snake
+// (0 hore, 1 vpravo, 2 dole, 3 vľavo) a počíta s prechodom cez okraj mapy.
+static inline uint64_t game_hash_edge(const Game *game, Point from, Point to) {
+    int dx = to.x - from.x;
+    int dy = to.y - from.y;
+    if (dx == game->width - 1) dx = -1;
+    if (dx == 1 - game->width) dx = 1;
+    if (dy == game->height - 1) dy = -1;
+    if (dy == 1 - game->height) dy = 1;
+
+    int kind = GAME_HASH_BODY;
+    if (dx == 0 && dy == -1) kind = GAME_HASH_EDGE + 0;
+    else if (dx == 1 && dy == 0) kind = GAME_HASH_EDGE + 1;
+    else if (dx == 0 && dy == 1) kind = GAME_HASH_EDGE + 2;
+    else if (dx == -1 && dy == 0) kind = GAME_HASH_EDGE + 3;
+    return game_hash_key(kind, from.y * game->width + from.x);
+}
+
+// Celý hash stavu (board_hash s hlavou, smerom a príznakom živého hada).
+static inline uint64_t game_hash(const Game *game) {
+    Point head = game->snake.body[0];
+    uint64_t hash = game->board_hash ^ game_hash_key(GAME_HASH_HEAD, head.y * game->width + head.x)
+                    ^ game_hash_key(GAME_HASH_DIRECTION, game->snake.direction);
+    return game->snake.alive ? hash : hash ^ game_hash_key(GAME_HASH_DEAD, 0);
+}
+
+// Spočíta board_hash prechodom celej mapy (overenie prírastkového hashu).
+uint64_t game_board_hash_compute(const Game *game);
+
+// Nastaví board_hash podľa mapy (po inicializácii alebo obnove zo snapshotu).
+void game_hash_rebuild(Game *game);
+
+#endif // GAME_HASH_H
@@ -0,0 +1,144 @@
+#include "game_items.h"
+#include "game_hash.h"
+
+static inline int cell_index(const Game *game, Point cell) {
+    return cell.y * game->width + cell.x;
+}
+
+// Pripočíta delta k voľným políčkam od indexu cell (strom je indexovaný od 1).
+static void free_tree_add(Game *game, int cell, int delta) {
+    size_t size = (size_t)game->width * (size_t)game->height;
+    for (size_t i = (size_t)cell + 1; i <= size; i += i & -i) {
+        game->free_tree[i] += delta;
+    }
+    game->free_count += delta;
+}
+
+// Index k-teho (od nuly) voľného políčka v poradí riadkov.
+static int free_tree_select(const Game *game, int k) {
+    size_t size = (size_t)game->width * (size_t)game->height;
+    size_t step = 1;
+    while (step * 2 <= size) step *= 2;
+
+    size_t position = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step <= size && game->free_tree[position + step] <= k) {
+            position += step;
+            k -= game->free_tree[position];
+        }
+    }
+    return (int)position; // Strom je od 1, políčka od 0
+}
+
+// Môže na políčku ležať predmet, ak ho nezaberá had?
+static int cell_can_hold_item(const Game *game, int x, int y) {
+    if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) return 0;
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) return 0;
+    return (game->cells[y * game->width + x] & CELL_ITEM_MASK) == ITEM_NONE;
+}
+
+static void cell_set_free(Game *game, int cell, int free) {
+    int was_free = (game->cells[cell] & CELL_FREE) != 0;
+    if (free == was_free) return;
+    game->cells[cell] ^= CELL_FREE;
+    free_tree_add(game, cell, free ? 1 : -1);
+}
+
+void game_items_rebuild(Game *game) {
+    size_t size = (size_t)game->width * (size_t)game->height;
+    for (int i = 0; i < ITEM_TYPES; i++) {
+        game->item_counts[i] = 0;
+    }
+    for (size_t cell = 0; cell < size; cell++) {
+        game->cells[cell] &= CELL_ITEM_MASK;
+        if (game->cells[cell] >= ITEM_TYPES) game->cells[cell] = ITEM_NONE;
+        game->item_counts[game->cells[cell]]++;
+    }
+    for (int i = 0; i < game->snake.length; i++) {
+        game->cells[cell_index(game, game->snake.body[i])] |= CELL_FREE; // Dočasne "had"
+    }
+
+    // Strom sa postaví lineárne: každý uzol pripočíta svoj súčet rodičovi
+    game->free_count = 0;
+    for (size_t i = 1; i <= size; i++) {
+        game->free_tree[i] = 0;
+    }
+    for (size_t cell = 0; cell < size; cell++) {
+        int snake_here = (game->cells[cell] & CELL_FREE) != 0;
+        int free = !snake_here
+                   && cell_can_hold_item(game, (int)(cell % (size_t)game->width), (int)(cell / (size_t)game->width));
+        game->cells[cell] = (uint8_t)((game->cells[cell] & CELL_ITEM_MASK) | (free ? CELL_FREE : 0));
+        game->free_tree[cell + 1] += free;
+        game->free_count += free;
+        size_t parent = (cell + 1) + ((cell + 1) & -(cell + 1));
+        if (parent <= size) game->free_tree[parent] += game->free_tree[cell + 1];
+    }
+}
+
+int game_spawn_item(Game *game, int item) {
+    if (game->free_count <= 0) return -1;
+    int cell = free_tree_select(game, (int)(game_rand(game) % (uint32_t)game->free_count));
+    cell_set_free(game, cell, 0);
+    game->cells[cell] = (uint8_t)item;
+    game->item_counts[item]++;
+    game->board_hash ^= game_hash_key(GAME_HASH_ITEM + item, cell);
+    return 0;
+}
+
+void game_cell_vacated(Game *game, Point cell) {
+    if (cell_can_hold_item(game, cell.x, cell.y)) {
+        cell_set_free(game, cell_index(game, cell), 1);
+    }
+}
+
+void game_cell_occupied(Game *game, Point cell) {
+    cell_set_free(game, cell_index(game, cell), 0);
+}
+
+void game_grow_snake(Game *game) {
+    if (game->snake.length >= MAX_SNAKE_LENGTH - 1) return;
+    Point *body = game->snake.body;
+    game_cell_occupied(game, body[game->snake.length]);
+    game->board_hash ^= game_hash_edge(game, body[game->snake.length - 1], body[game->snake.length]);
+    game->snake.length += 1;
+}
+
+void game_shrink_snake(Game *game, int count) {
+    for (int i = 0; i < count && game->snake.length > 1; i++) {
+        game->snake.length -= 1;
+        Point *body = game->snake.body;
+        game_cell_vacated(game, body[game->snake.length]);
+        game->board_hash ^= game_hash_edge(game, body[game->snake.length - 1], body[game->snake.length]);
+    }
+}
+
+int game_collect_item(Game *game) {
+    if (game->speed_ticks > 0) game->speed_ticks--;
+
+    Point head = game->snake.body[0];
+    int cell = cell_index(game, head);
+    int item = game->cells[cell] & CELL_ITEM_MASK;
+    if (item != ITEM_NONE) {
+        game->cells[cell] &= (uint8_t)~CELL_ITEM_MASK; // Políčko ostáva obsadené hlavou
+        game->item_counts[item]--;
+        game->board_hash ^= game_hash_key(GAME_HASH_ITEM + item, cell);
+        if (item == ITEM_FRUIT) {
+            game->fruits_eaten++;
+            game_grow_snake(game);
+        } else if (item == ITEM_SPEED) {
+            game->speed_ticks = SPEED_BOOST_TICKS;
+        } else if (item == ITEM_SHRINK) {
+            game_shrink_snake(game, SHRINK_AMOUNT);
+        }
+    }
+
+    while (game->item_counts[ITEM_FRUIT] < game->fruit_target && game_spawn_item(game, ITEM_FRUIT) == 0) {
+    }
+    if (++game->spawn_counter >= POWERUP_INTERVAL) {
+        game->spawn_counter = 0;
+        if (game->item_counts[ITEM_SPEED] + game->item_counts[ITEM_SHRINK] < MAX_POWERUPS) {
+            game_spawn_item(game, game_rand(game) & 1 ? ITEM_SHRINK : ITEM_SPEED);
+        }
+    }
+    return item;
+}
@@ -0,0 +1,57 @@
+#ifndef GAME_ITEMS_H
+#define GAME_ITEMS_H
+
+#include "game_logic.h"
+
+// Predmety na mape (ovocie a power-upy) sú v mriežke game->cells indexovanej políčkom
+// (y * width + x), takže zber pod hlavou je jedno čítanie a vykreslenie nezávisí od ich počtu.
+// Voľné políčka (vnútri mapy, bez prekážky, hada a predmetu) sú v binárnom indexovanom
+// (Fenwickovom) strome: nový predmet padne na k-te voľné políčko v poradí riadkov za O(log n).
+
+#define ITEM_NONE 0
+#define ITEM_FRUIT 1   // Predĺži hada a pripočíta bod
+#define ITEM_SPEED 2   // Zrýchli hada na SPEED_BOOST_TICKS ťahov
+#define ITEM_SHRINK 3  // Skráti hada o SHRINK_AMOUNT článkov
+#define ITEM_TYPES 4
+
+#define CELL_ITEM_MASK 0x0f
+#define CELL_FREE 0x80         // Políčko je započítané vo free_tree
+
+#define MAX_FRUITS 256         // Najviac ovocí naraz
+#define POWERUP_INTERVAL 15    // Po koľkých ťahoch sa skúsi položiť power-up
+#define MAX_POWERUPS 3         // Najviac power-upov naraz
+#define SPEED_BOOST_TICKS 10
+#define SHRINK_AMOUNT 3
+
+// Znak predmetu vo vykreslenej mape.
+static inline char item_symbol(int item) {
+    static const char symbols[ITEM_TYPES] = {'.', 'F', '+', '-'};
+    return symbols[item & CELL_ITEM_MASK];
+}
+
+static inline int game_item_at(const Game *game, int x, int y) {
+    return game->cells[y * game->width + x] & CELL_ITEM_MASK;
+}
+
+// Prepočíta voľné políčka z prekážok, hada a predmetov (po inicializácii alebo obnove).
+void game_items_rebuild(Game *game);
+
+// Položí predmet na náhodné voľné políčko. Vráti 0, alebo -1, ak voľné políčko nie je.
+int game_spawn_item(Game *game, int item);
+
+// Had opustil políčko alebo naň vstúpil (volá move_snake a zmeny dĺžky). Hrany tela v board_hash
+// mení volajúci (game_hash_edge).
+void game_cell_vacated(Game *game, Point cell);
+void game_cell_occupied(Game *game, Point cell);
+
+// Predĺži hada o starý chvost (body[length]), najviac na MAX_SNAKE_LENGTH - 1.
+void game_grow_snake(Game *game);
+
+// Skráti hada o count článkov (ostane aspoň hlava).
+void game_shrink_snake(Game *game, int count);
+
+// Po úspešnom ťahu zoberie predmet pod hlavou, uplatní jeho účinok a doplní predmety.
+// Vráti typ zobraného predmetu alebo ITEM_NONE.
+int game_collect_item(Game *game);
+
+#endif // GAME_ITEMS_H
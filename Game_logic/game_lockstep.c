@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <string.h>
+#include "game_hash.h"
+#include "game_items.h"
+#include "game_lockstep.h"
+#include "game_snapshot.h"
+
+static inline int history_index(unsigned int tick) {
+    return (int)(tick & (LOCKSTEP_HISTORY - 1));
+}
+
+size_t lockstep_write_state(const Game *game, int64_t now_ms, void *buffer, size_t size) {
+    // Plytká kópia zdieľa mriežky, mení sa len hlavička snapshotu
+    Game relative = *game;
+    relative.start_ms = -game_elapsed_ms(game, now_ms);
+    relative.pause_start_ms = 0;
+    relative.total_pause_ms = 0;
+    relative.paused_message_sent = 0;
+    relative.player_status.paused = 0;
+    return game_snapshot_write(&relative, buffer, size);
+}
+
+void lockstep_init(LockstepSession *session) {
+    memset(session, 0, sizeof(*session));
+    session->pending_input = LOCKSTEP_NO_INPUT;
+}
+
+void lockstep_free(LockstepSession *session) {
+    for (int i = 0; i < LOCKSTEP_HISTORY; i++) {
+        free(session->slots[i].data);
+    }
+    free(session->grid);
+    lockstep_init(session);
+}
+
+// Uloží stav po ťahu session->tick do kruhu. Slot sa zväčší len pri dlhšom hadovi alebo viac predmetoch.
+static int lockstep_save(LockstepSession *session) {
+    LockstepSlot *slot = &session->slots[history_index(session->tick)];
+    size_t size = game_snapshot_size(&session->game);
+    if (slot->capacity < size) {
+        void *grown = realloc(slot->data, size);
+        if (!grown) return -1;
+        slot->data = grown;
+        slot->capacity = size;
+    }
+    slot->size = game_snapshot_write(&session->game, slot->data, slot->capacity);
+    slot->tick = session->tick;
+    return slot->size > 0 ? 0 : -1;
+}
+
+// Obnoví stav po ťahu tick z kruhu. Vráti -1, ak už bol prepísaný.
+static int lockstep_restore(LockstepSession *session, unsigned int tick) {
+    LockstepSlot *slot = &session->slots[history_index(tick)];
+    if (slot->size == 0 || slot->tick != tick) return -1;
+    int64_t start_ms = session->game.start_ms; // Čas hry beží ďalej podľa hodín klienta
+    if (game_snapshot_restore_into(&session->game, slot->data, slot->size, session->grid,
+                                   session->grid_capacity) < 0) {
+        return -1;
+    }
+    session->game.start_ms = start_ms;
+    session->tick = tick;
+    return 0;
+}
+
+// Jeden ťah simulácie rovnako ako na serveri (room_tick). direction >= 0 sa nastaví priamo
+// (potvrdený smer), inak sa použije lokálny vstup input.
+static void lockstep_step(LockstepSession *session, int direction, int input) {
+    Game *game = &session->game;
+    if (direction >= 0) {
+        game->snake.direction = direction;
+    } else if (input != LOCKSTEP_NO_INPUT) {
+        change_direction(&game->snake, input);
+    }
+    session->tick++;
+    session->inputs[history_index(session->tick)] = (int8_t)input;
+    session->directions[history_index(session->tick)] = (int8_t)game->snake.direction;
+    if (move_snake(game)) {
+        game_collect_item(game);
+    }
+    session->hashes[history_index(session->tick)] = game_hash(game);
+    lockstep_save(session);
+}
+
+int lockstep_load(LockstepSession *session, const void *state, size_t size, unsigned int tick) {
+    if (size < sizeof(GameSnapshotHeader)) return -1;
+    const GameSnapshotHeader *header = state;
+    if (header->width <= 0 || header->height <= 0) return -1;
+    size_t grid_size = game_grid_size(header->width, header->height);
+    if (session->grid_capacity < grid_size) {
+        void *grown = realloc(session->grid, grid_size);
+        if (!grown) return -1;
+        session->grid = grown;
+        session->grid_capacity = grid_size;
+    }
+    if (game_snapshot_restore_into(&session->game, state, size, session->grid, session->grid_capacity) < 0) {
+        session->loaded = 0;
+        return -1;
+    }
+    session->game.start_ms += game_clock_ms(); // Relatívny čas od servera na hodiny klienta
+
+    for (int i = 0; i < LOCKSTEP_HISTORY; i++) {
+        session->slots[i].size = 0;
+    }
+    session->tick = tick;
+    session->confirmed_tick = tick;
+    session->pending_input = LOCKSTEP_NO_INPUT;
+    session->hashes[history_index(tick)] = game_hash(&session->game);
+    session->loaded = 1;
+    return lockstep_save(session);
+}
+
+void lockstep_input(LockstepSession *session, int direction) {
+    // Viac vstupov medzi ťahmi sa skladá ako na serveri, kde každý prejde cez change_direction
+    Snake planned = {.direction = session->pending_input != LOCKSTEP_NO_INPUT
+                                  ? session->pending_input : session->game.snake.direction};
+    change_direction(&planned, direction);
+    session->pending_input = planned.direction;
+}
+
+int lockstep_predict(LockstepSession *session) {
+    if (!session->loaded || !session->game.snake.alive
+        || session->tick - session->confirmed_tick >= LOCKSTEP_MAX_PREDICTION) {
+        return 0;
+    }
+    lockstep_step(session, -1, session->pending_input);
+    session->pending_input = LOCKSTEP_NO_INPUT;
+    return 1;
+}
+
+// Porovná potvrdený stav po ťahu tick s hashom od servera. Rozídená simulácia sa zastaví.
+static int lockstep_check_hash(LockstepSession *session, unsigned int tick, uint64_t hash, int result) {
+    if (hash != 0 && session->hashes[history_index(tick)] != hash) {
+        session->desyncs++;
+        session->loaded = 0;
+        return -1;
+    }
+    return result;
+}
+
+int lockstep_confirm(LockstepSession *session, unsigned int tick, int direction, uint64_t hash) {
+    if (!session->loaded || tick <= session->confirmed_tick) return 0; // Starý alebo zopakovaný ťah
+    if (tick != session->confirmed_tick + 1 || direction < 0 || direction > 3) return -1;
+    session->confirmed_tick = tick;
+
+    if (tick > session->tick) {
+        // Server je vpredu (klient nepredpovedal): ťah sa len dobehne
+        lockstep_step(session, direction, LOCKSTEP_NO_INPUT);
+        return lockstep_check_hash(session, tick, hash, 1);
+    }
+    if (session->directions[history_index(tick)] == direction) {
+        return lockstep_check_hash(session, tick, hash, 0); // Predpoveď sedela
+    }
+
+    // Rollback: stav pred ťahom tick, potvrdený smer a znova predpovedané ťahy po ňom
+    unsigned int predicted_tick = session->tick;
+    if (lockstep_restore(session, tick - 1) < 0) {
+        session->loaded = 0;
+        return -1;
+    }
+    lockstep_step(session, direction, LOCKSTEP_NO_INPUT);
+    while (session->tick < predicted_tick) {
+        lockstep_step(session, -1, session->inputs[history_index(session->tick + 1)]);
+    }
+    session->rollbacks++;
+    session->resimulated_ticks += predicted_tick - tick + 1;
+    return lockstep_check_hash(session, tick, hash, 1);
+}
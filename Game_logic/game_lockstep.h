@@ -0,0 +1,68 @@
+#ifndef GAME_LOCKSTEP_H
+#define GAME_LOCKSTEP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// Lockstep s rollbackom: klient simuluje tú istú hru ako server (ťah je deterministický,
+// náhoda ide len z rng_state hry). Server po každom ťahu pošle len smer, ktorým had v ťahu
+// išiel, a klient ťahy medzitým predpovedá s vlastnými vstupmi. Ak server použil iný smer
+// (vstup prišiel neskôr alebo skôr, ako klient čakal), klient obnoví stav pred daným ťahom
+// z kruhu snapshotov a predpovedané ťahy odsimuluje znova.
+//
+// Ťah t je stav po t posunoch hada (Room.tick). Kruh drží snapshot stavu po každom z
+// posledných LOCKSTEP_HISTORY ťahov. Server k ťahu posiela aj hash stavu (game_hash.h);
+// ak sa potvrdený stav klienta od neho líši, simulácia sa rozišla a treba nový stav.
+
+#define LOCKSTEP_HISTORY 32         // Počet ťahov v kruhu snapshotov (mocnina dvoch)
+#define LOCKSTEP_MAX_PREDICTION 2   // O koľko ťahov smie klient predbehnúť posledný potvrdený
+#define LOCKSTEP_NO_INPUT -1
+
+typedef struct {
+    void *data;
+    size_t size;
+    size_t capacity;
+    unsigned int tick;
+} LockstepSlot;
+
+typedef struct {
+    Game game;                   // Aktuálny (možno predpovedaný) stav
+    void *grid;                  // Mriežky hry (game_grid_size), patria relácii
+    size_t grid_capacity;
+    unsigned int tick;           // Ťah, ktorý game predstavuje
+    unsigned int confirmed_tick; // Posledný ťah potvrdený serverom
+    int pending_input;           // Lokálny vstup pre ďalší predpovedaný ťah
+    int8_t inputs[LOCKSTEP_HISTORY];     // Lokálny vstup predpovedaného ťahu t (index t % HISTORY)
+    int8_t directions[LOCKSTEP_HISTORY]; // Smer, ktorým had v ťahu t išiel
+    uint64_t hashes[LOCKSTEP_HISTORY];   // game_hash stavu po ťahu t
+    LockstepSlot slots[LOCKSTEP_HISTORY];
+    uint64_t rollbacks;          // Počet obnovení zo snapshotu
+    uint64_t resimulated_ticks;  // Ťahy odsimulované znova pri rollbackoch
+    uint64_t desyncs;            // Potvrdené ťahy, ktorých hash nesedel so serverom
+    int loaded;
+} LockstepSession;
+
+// Zapíše snapshot hry pre lockstep klienta. Časy hry sú relatívne (start_ms = -odohraný čas
+// bez pauzy), lebo klient má iné monotónne hodiny. Vráti veľkosť alebo 0, ak je buffer malý.
+size_t lockstep_write_state(const Game *game, int64_t now_ms, void *buffer, size_t size);
+
+void lockstep_init(LockstepSession *session);
+void lockstep_free(LockstepSession *session);
+
+// Začne (alebo znova zosynchronizuje) simuláciu zo stavu od servera v ťahu tick. Vráti 0 alebo -1.
+int lockstep_load(LockstepSession *session, const void *state, size_t size, unsigned int tick);
+
+// Lokálny vstup hráča: prejaví sa v najbližšom predpovedanom ťahu (pravidlá ako change_direction).
+void lockstep_input(LockstepSession *session, int direction);
+
+// Odsimuluje ďalší ťah dopredu s lokálnymi vstupmi. Vráti 1, ak sa ťah urobil, 0 ak klient
+// už predbehol server o LOCKSTEP_MAX_PREDICTION ťahov alebo had nežije.
+int lockstep_predict(LockstepSession *session);
+
+// Server potvrdil, že v ťahu tick had išiel smerom direction a stav po ňom má hash (0 = neznámy).
+// Vráti 0, ak predpoveď sedela, 1 ak sa stav zmenil (rollback alebo dobehnutie servera), -1 ak
+// ťah nenadväzuje, je mimo kruhu snapshotov alebo hash nesedí (treba nový stav od servera).
+int lockstep_confirm(LockstepSession *session, unsigned int tick, int direction, uint64_t hash);
+
+#endif // GAME_LOCKSTEP_H
@@ -1,14 +1,149 @@
 #include "game_logic.h"
+#include "game_hash.h"
+#include "game_items.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
+#include <string.h>
 
 // Helper to check if two points are equal
 int points_equal(Point a, Point b) {
     return a.x == b.x && a.y == b.y;
 }
 
+// xorshift32 - stav je jedno 32-bitové číslo, takže sa dá uložiť do snapshotu
+uint32_t game_rand(Game *game) {
+    uint32_t x = game->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game->rng_state = x;
+    return x;
+}
+
+// Vyberie `count` rôznych vnútorných políčok čiastočným Fisher-Yates premiešaním (O(count)
+// po naplnení zoznamu kandidátov) a potom jedným BFS prechodom zaleje uzavreté kapsy, aby
+// každé voľné vnútorné políčko bolo dosiahnuteľné zo štartu hada.
+static void place_obstacles(Game *game, int count) {
+    int inner_width = game->width - 2;
+    int inner_height = game->height - 2;
+    if (inner_width <= 0 || inner_height <= 0) return;
+
+    int cells = inner_width * inner_height;
+    int *candidates = malloc(cells * sizeof(int));
+    if (!candidates) return;
+
+    // Štart hada a políčko pred ním (had začína smerom vpravo) ostanú voľné
+    Point start = game->snake.body[0];
+    Point ahead = {start.x + 1, start.y};
+    int candidate_count = 0;
+    for (int y = 1; y <= inner_height; y++) {
+        for (int x = 1; x <= inner_width; x++) {
+            if (points_equal((Point){x, y}, start) || points_equal((Point){x, y}, ahead)) continue;
+            candidates[candidate_count++] = y * game->width + x;
+        }
+    }
+    if (count > candidate_count) count = candidate_count;
+
+    for (int i = 0; i < count; i++) {
+        int j = i + (int)(game_rand(game) % (uint32_t)(candidate_count - i));
+        int cell = candidates[j];
+        candidates[j] = candidates[i];
+        candidates[i] = cell;
+        game->obstacles[cell / game->width][cell % game->width] = 1;
+    }
+
+    int start_inside = start.x >= 1 && start.x <= inner_width && start.y >= 1 && start.y <= inner_height;
+    if (!start_inside) {
+        free(candidates);
+        return;
+    }
+
+    // BFS zo štartu po voľných vnútorných políčkach; zoznam kandidátov poslúži ako fronta.
+    // Dosiahnuté políčka sa dočasne označia hodnotou 2.
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    int head = 0, tail = 0;
+    candidates[tail++] = start.y * game->width + start.x;
+    game->obstacles[start.y][start.x] = 2;
+    while (head < tail) {
+        int cell = candidates[head++];
+        int cx = cell % game->width, cy = cell / game->width;
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + dx[d], ny = cy + dy[d];
+            if (nx < 1 || nx > inner_width || ny < 1 || ny > inner_height) continue;
+            if (game->obstacles[ny][nx] != 0) continue;
+            game->obstacles[ny][nx] = 2;
+            candidates[tail++] = ny * game->width + nx;
+        }
+    }
+
+    // Nedosiahnuté voľné políčka sa stanú prekážkami, dosiahnuté sa vrátia na voľné
+    for (int y = 1; y <= inner_height; y++) {
+        int *row = game->obstacles[y];
+        for (int x = 1; x <= inner_width; x++) {
+            row[x] = row[x] == 2 ? 0 : 1;
+        }
+    }
+
+    free(candidates);
+}
+
+int64_t game_clock_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int64_t game_elapsed_ms(const Game *game, int64_t now_ms) {
+    int64_t elapsed = now_ms - game->start_ms - game->total_pause_ms;
+    if (game->paused_message_sent) {
+        elapsed -= now_ms - game->pause_start_ms; // Prebiehajúca pauza sa nepočíta
+    }
+    return elapsed > 0 ? elapsed : 0;
+}
+
+size_t game_grid_size(int width, int height) {
+    size_t cells = (size_t)width * (size_t)height;
+    return (size_t)height * sizeof(int *) + cells * sizeof(int) + (cells + 1) * sizeof(int32_t) + cells;
+}
+
+void game_grid_attach(Game *game, void *storage) {
+    // Ukazovatele na riadky sú na začiatku bloku, za nimi prekážky všetkých riadkov,
+    // strom voľných políčok a nakoniec predmety
+    size_t cells = (size_t)game->width * (size_t)game->height;
+    int **rows = storage;
+    int *obstacle_cells = (int *)(rows + game->height);
+    memset(obstacle_cells, 0, cells * sizeof(int));
+    for (int y = 0; y < game->height; y++) {
+        rows[y] = obstacle_cells + (size_t)y * game->width;
+    }
+    game->obstacles = rows;
+    game->free_tree = (int32_t *)(obstacle_cells + cells);
+    game->cells = (uint8_t *)(game->free_tree + cells + 1);
+    memset(game->cells, 0, cells);
+}
+
 void initialize_game(Game *game, int width, int height, int mode, int time_limit, int world_type) {
+    initialize_game_seeded(game, width, height, mode, time_limit, world_type, (uint32_t)time(NULL));
+}
+
+void initialize_game_seeded(Game *game, int width, int height, int mode, int time_limit, int world_type,
+                            uint32_t seed) {
+    // Mriežka prekážok je jeden blok namiesto alokácie pre každý riadok
+    void *grid = malloc(game_grid_size(width, height));
+    if (!grid) {
+        game->obstacles = NULL;
+        game->owns_grid = 0;
+        return;
+    }
+    initialize_game_in(game, grid, width, height, mode, time_limit, world_type, seed);
+    game->owns_grid = 1;
+}
+
+void initialize_game_in(Game *game, void *grid, int width, int height, int mode, int time_limit,
+                        int world_type, uint32_t seed) {
     game->width = width;
     game->height = height;
     game->snake.length = 1;
@@ -18,9 +153,9 @@ void initialize_game(Game *game, int width, int height, int mode, int time_limit
     game->snake.alive = 1;
     game->mode = mode;
     game->time_limit = time_limit;
-    game->start_time = time(NULL);
-    game->pause_start = 0;
-    game->total_pause_time = 0;
+    game->start_ms = game_clock_ms();
+    game->pause_start_ms = 0;
+    game->total_pause_ms = 0;
     game->world_type = world_type;
 
     // Inicializácia stavu hráča
@@ -29,29 +164,34 @@ void initialize_game(Game *game, int width, int height, int mode, int time_limit
 
     game->paused_message_sent = 0;
 
-    srand(time(NULL));
-
-    // Alokácia prekážok
-    game->obstacles = malloc(height * sizeof(int *));
-    for (int i = 0; i < height; i++) {
-        game->obstacles[i] = calloc(width, sizeof(int));
+    game->rng_state = seed;
+    if (game->rng_state == 0) {
+        game->rng_state = 1; // xorshift nesmie začínať nulou
     }
+    game->fruit_target = 1;
+    game->fruits_eaten = 0;
+    game->speed_ticks = 0;
+    game->spawn_counter = 0;
+
+    game->owns_grid = 0;
+    game_grid_attach(game, grid);
 
     if (world_type == WORLD_WITH_OBSTACLES) {
-        for (int i = 0; i < width * height / 10; i++) {
-            int x, y;
-            do {
-                x = rand() % (width - 2) + 1;
-                y = rand() % (height - 2) + 1;
-            } while (points_equal((Point){x, y}, game->snake.body[0]) || game->obstacles[y][x] == 1);
-
-            game->obstacles[y][x] = 1;
-        }
+        place_obstacles(game, width * height / 10);
     }
 
+    game_items_rebuild(game);
+    game_hash_rebuild(game);
     generate_fruit(game);
 }
 
+void release_game(Game *game) {
+    if (game->obstacles && game->owns_grid) {
+        free(game->obstacles);
+    }
+    game->obstacles = NULL;
+    game->owns_grid = 0;
+}
 
 int move_snake(Game *game) {
     if (!game->snake.alive || game->player_status.paused) {
@@ -84,13 +224,26 @@ int move_snake(Game *game) {
         return 0;
     }
 
-    for (int i = game->snake.length; i > 0; i--) {
+    // Starý chvost ostáva za telom (body[length]) pre prípadné predĺženie
+    Point tail = game->snake.body[game->snake.length - 1];
+    int last = game->snake.length < MAX_SNAKE_LENGTH ? game->snake.length : MAX_SNAKE_LENGTH - 1;
+    for (int i = last; i > 0; i--) {
         game->snake.body[i] = game->snake.body[i - 1];
     }
 
     game->snake.body[0] = head;
+    game_cell_vacated(game, tail);
+    game_cell_occupied(game, head);
+    if (game->snake.length > 1) {
+        // Nová hlava dostane hranu k starej hlave, predposledný článok stratí hranu k chvostu
+        game->board_hash ^= game_hash_edge(game, head, game->snake.body[1])
+                            ^ game_hash_edge(game, game->snake.body[game->snake.length - 1], tail);
+    }
 
-    if (check_collision(game)) {
+    TRACE_BEGIN(collision);
+    int collided = check_collision(game);
+    TRACE_END(collision);
+    if (collided) {
         game->snake.alive = 0;
         return 0;
     }
@@ -119,29 +272,7 @@ int check_collision(const Game *game) {
 }
 
 void generate_fruit(Game *game) {
-    int x, y;
-    int collision;
-
-    do {
-        collision = 0;
-        x = rand() % game->width;
-        y = rand() % game->height;
-
-        // Ensure fruit is not placed on the snake or on the walls
-        if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) {
-            collision = 1; // Avoid walls
-        }
-
-        for (int i = 0; i < game->snake.length; i++) {
-            if (game->snake.body[i].x == x && game->snake.body[i].y == y) {
-                collision = 1; // Avoid snake body
-                break;
-            }
-        }
-    } while (collision);
-
-    game->fruit.x = x;
-    game->fruit.y = y;
+    game_spawn_item(game, ITEM_FRUIT);
 }
 
 void draw_game(const Game *game) {
@@ -152,8 +283,8 @@ void draw_game(const Game *game) {
                 printf("#");
             } else if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) {
                 printf("#");
-            } else if (points_equal(game->fruit, (Point){x, y})) {
-                printf("F");
+            } else if (game_item_at(game, x, y) != ITEM_NONE) {
+                printf("%c", item_symbol(game_item_at(game, x, y)));
             } else {
                 int is_snake = 0;
                 for (int i = 0; i < game->snake.length; i++) {
@@ -1,3 +1,5 @@
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifndef GAME_LOGIC_H
@@ -30,23 +32,60 @@ typedef struct {
     int width;
     int height;
     Snake snake;
-    Point fruit;
     int mode;             // Game mode: STANDARD or TIMED
     int time_limit;       // Time limit in seconds (for timed mode)
-    time_t start_time;    // Start time of the game
+    int64_t start_ms;     // Start time of the game (monotonic clock, ms)
     int world_type;       // Type of world: WORLD_NO_OBSTACLES or WORLD_WITH_OBSTACLES
-    int **obstacles;      // 2D array for obstacles
+    int **obstacles;      // 2D array for obstacles (riadky v jednom bloku, viď game_grid_attach)
+    int owns_grid;        // 1, ak release_game má mriežku uvoľniť (inak patrí napr. aréne miestnosti)
     PlayerStatus player_status; // Stav hráča
     int paused_message_sent;
-    time_t pause_start; // Čas, kedy sa hra pozastavila
-    time_t total_pause_time; // Celkový čas strávený v pauze
+    int64_t pause_start_ms; // Čas, kedy sa hra pozastavila (monotónne hodiny, ms)
+    int64_t total_pause_ms; // Celkový čas strávený v pauze v milisekundách
+    uint32_t rng_state;   // Stav generátora náhodných čísel hry (xorshift32)
+    uint8_t *cells;       // Predmet na políčku a príznak voľného políčka (viď game_items.h)
+    int32_t *free_tree;   // Fenwickov strom počtov voľných políčok (width * height + 1)
+    int free_count;       // Počet voľných políčok (kam sa dá položiť predmet)
+    int item_counts[4];   // Počet predmetov každého typu na mape (index ITEM_*)
+    int fruit_target;     // Koľko ovocí má byť na mape naraz
+    int fruits_eaten;     // Skóre hráča
+    int speed_ticks;      // Zostávajúce ťahy zrýchlenia
+    int spawn_counter;    // Ťahy od posledného pokusu o power-up
+    uint64_t board_hash;  // Zobristov hash hada, predmetov a prekážok (viď game_hash.h)
 } Game;
 
 int points_equal(Point a, Point b);
 
+// Monotónny čas v milisekundách, v ktorom sa meria trvanie hry a pauzy.
+int64_t game_clock_ms(void);
+
+// Odohraný čas hry v milisekundách (bez prestávok).
+int64_t game_elapsed_ms(const Game *game, int64_t now_ms);
+
+// Vráti ďalšie pseudonáhodné číslo z generátora hry (deterministické pre daný stav).
+uint32_t game_rand(Game *game);
+
 // Inicializuje hru so zadanou šírkou a výškou.
 void initialize_game(Game *game, int width, int height, int mode, int time_limit, int world_type);
 
+// Ako initialize_game, ale generátor (prekážky aj ovocie) začína zo zadaného semena.
+void initialize_game_seeded(Game *game, int width, int height, int mode, int time_limit, int world_type,
+                            uint32_t seed);
+
+// Ako initialize_game_seeded, ale mriežka prekážok sa uloží do bloku grid veľkosti
+// game_grid_size, ktorý patrí volajúcemu (nič sa nealokuje ani neuvoľňuje).
+void initialize_game_in(Game *game, void *grid, int width, int height, int mode, int time_limit,
+                        int world_type, uint32_t seed);
+
+// Veľkosť bloku pre mriežky hry (prekážky s ukazovateľmi na riadky, predmety a strom voľných políčok).
+size_t game_grid_size(int width, int height);
+
+// Rozloží prázdne mriežky rozmeru game->width x game->height do bloku storage.
+void game_grid_attach(Game *game, void *storage);
+
+// Uvoľní pamäť alokovanú v initialize_game (mriežku prekážok).
+void release_game(Game *game);
+
 // Pohybuje hadom v aktuálnom smere. Vráti 1, ak had zje ovocie, 0 inak.
 int move_snake(Game *game);
 
@@ -56,7 +95,7 @@ void change_direction(Snake *snake, int new_direction);
 // Skontroluje kolízie (had narazí do seba alebo steny).
 int check_collision(const Game *game);
 
-// Generuje nové ovocie na náhodnej pozícii.
+// Položí jedno nové ovocie na náhodné voľné políčko.
 void generate_fruit(Game *game);
 
 // Deklarácia funkcie na vykreslenie hernej plochy (bez definície).
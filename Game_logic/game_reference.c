@@ -0,0 +1,162 @@
+#include "game_reference.h"
+
+int reference_move_snake(Game *game) {
+    if (!game->snake.alive || game->player_status.paused) {
+        return 0;
+    }
+
+    Point head = game->snake.body[0];
+    switch (game->snake.direction) {
+        case 0: head.y -= 1; break; // Hore
+        case 1: head.x += 1; break; // Vpravo
+        case 2: head.y += 1; break; // Dole
+        case 3: head.x -= 1; break; // Vľavo
+    }
+
+    // Bez prekážok sa prechádza cez okraj, inak okraj zabíja
+    if (head.x < 0 || head.x >= game->width || head.y < 0 || head.y >= game->height) {
+        if (game->world_type == WORLD_NO_OBSTACLES) {
+            if (head.x < 0) head.x = game->width - 1;
+            if (head.x >= game->width) head.x = 0;
+            if (head.y < 0) head.y = game->height - 1;
+            if (head.y >= game->height) head.y = 0;
+        } else {
+            game->snake.alive = 0;
+            return 0;
+        }
+    }
+
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[head.y][head.x] == 1) {
+        game->snake.alive = 0;
+        return 0;
+    }
+
+    // Starý chvost ostáva za telom (body[length]) pre prípadné predĺženie
+    int last = game->snake.length < MAX_SNAKE_LENGTH ? game->snake.length : MAX_SNAKE_LENGTH - 1;
+    for (int i = last; i > 0; i--) {
+        game->snake.body[i] = game->snake.body[i - 1];
+    }
+    game->snake.body[0] = head;
+
+    if (reference_check_collision(game)) {
+        game->snake.alive = 0;
+        return 0;
+    }
+    return 1;
+}
+
+void reference_change_direction(Snake *snake, int new_direction) {
+    if ((snake->direction + 2) % 4 != new_direction) {
+        snake->direction = new_direction; // Otočenie o 180 stupňov sa ignoruje
+    }
+}
+
+int reference_check_collision(const Game *game) {
+    Point head = game->snake.body[0];
+    for (int i = 1; i < game->snake.length; i++) {
+        if (points_equal(head, game->snake.body[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Políčko je voľné, ak je vnútri mapy a nie je na ňom prekážka, predmet ani had.
+static int reference_cell_free(const Game *game, int x, int y) {
+    if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) return 0;
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) return 0;
+    if ((game->cells[y * game->width + x] & CELL_ITEM_MASK) != ITEM_NONE) return 0;
+    for (int i = 0; i < game->snake.length; i++) {
+        if (game->snake.body[i].x == x && game->snake.body[i].y == y) return 0;
+    }
+    return 1;
+}
+
+int reference_spawn_item(Game *game, int item) {
+    int free_count = 0;
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            free_count += reference_cell_free(game, x, y);
+        }
+    }
+    if (free_count == 0) return -1;
+
+    // k-te voľné políčko v poradí riadkov
+    int k = (int)(game_rand(game) % (uint32_t)free_count);
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            if (reference_cell_free(game, x, y) && k-- == 0) {
+                game->cells[y * game->width + x] = (uint8_t)item;
+                game->item_counts[item]++;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+void reference_generate_fruit(Game *game) {
+    reference_spawn_item(game, ITEM_FRUIT);
+}
+
+int reference_collect_item(Game *game) {
+    if (game->speed_ticks > 0) game->speed_ticks--;
+
+    Point head = game->snake.body[0];
+    uint8_t *cell = &game->cells[head.y * game->width + head.x];
+    int item = *cell & CELL_ITEM_MASK;
+    if (item != ITEM_NONE) {
+        *cell = ITEM_NONE;
+        game->item_counts[item]--;
+        if (item == ITEM_FRUIT) {
+            game->fruits_eaten++;
+            if (game->snake.length < MAX_SNAKE_LENGTH - 1) {
+                game->snake.length += 1; // Starý chvost ostal v body[length]
+            }
+        } else if (item == ITEM_SPEED) {
+            game->speed_ticks = SPEED_BOOST_TICKS;
+        } else if (item == ITEM_SHRINK) {
+            for (int i = 0; i < SHRINK_AMOUNT && game->snake.length > 1; i++) {
+                game->snake.length -= 1;
+            }
+        }
+    }
+
+    while (game->item_counts[ITEM_FRUIT] < game->fruit_target && reference_spawn_item(game, ITEM_FRUIT) == 0) {
+    }
+    if (++game->spawn_counter >= POWERUP_INTERVAL) {
+        game->spawn_counter = 0;
+        if (game->item_counts[ITEM_SPEED] + game->item_counts[ITEM_SHRINK] < MAX_POWERUPS) {
+            reference_spawn_item(game, game_rand(game) & 1 ? ITEM_SHRINK : ITEM_SPEED);
+        }
+    }
+    return item;
+}
+
+int reference_draw_map(const Game *game, char *buffer, size_t size) {
+    if ((size_t)(game->width + 1) * (size_t)game->height > size) return -1;
+
+    int index = 0;
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) {
+                buffer[index++] = '#';
+            } else if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) {
+                buffer[index++] = '#';
+            } else if ((game->cells[y * game->width + x] & CELL_ITEM_MASK) != ITEM_NONE) {
+                buffer[index++] = item_symbol(game->cells[y * game->width + x]);
+            } else {
+                int is_snake = 0;
+                for (int i = 0; i < game->snake.length; i++) {
+                    if (points_equal(game->snake.body[i], (Point){x, y})) {
+                        is_snake = 1;
+                        break;
+                    }
+                }
+                buffer[index++] = is_snake ? 'O' : '.';
+            }
+        }
+        buffer[index++] = '\n';
+    }
+    return index;
+}
@@ -0,0 +1,27 @@
+#ifndef GAME_REFERENCE_H
+#define GAME_REFERENCE_H
+
+#include <stddef.h>
+#include "game_logic.h"
+#include "game_items.h"
+
+// Referenčná (zámerne neoptimalizovaná) kópia pravidiel hry. Slúži ako meradlo pre
+// rýchlejšie implementácie (game_logic, SnakeBatch, vykresľovanie): pri zmene pravidiel sa
+// musí upraviť aj táto kópia, pri optimalizácii nikdy.
+
+int reference_move_snake(Game *game);
+void reference_change_direction(Snake *snake, int new_direction);
+int reference_check_collision(const Game *game);
+void reference_generate_fruit(Game *game);
+
+// Položí predmet na k-te voľné políčko (voľné políčka sa zakaždým spočítajú prechodom mapy).
+int reference_spawn_item(Game *game, int item);
+
+// Zber predmetu pod hlavou, jeho účinok a doplnenie predmetov ako game_collect_item.
+int reference_collect_item(Game *game);
+
+// Vykreslí iba mapu (riadky ukončené '\n', bez súhrnu) ako draw_game_to_buffer.
+// Vráti počet zapísaných znakov alebo -1, ak sa mapa nezmestí do size.
+int reference_draw_map(const Game *game, char *buffer, size_t size);
+
+#endif // GAME_REFERENCE_H
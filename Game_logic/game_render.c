@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include "game_render.h"
+
+int game_draw_summary(const Game *game, char *buffer, int index, size_t size) {
+    int game_duration = (int)(game_elapsed_ms(game, game_clock_ms()) / 1000);
+    index += snprintf(buffer + index, size - index,
+                      "Ovocie: %d\nDĺžka hry: %d sekúnd\n",
+                      game->fruits_eaten, game_duration);
+    buffer[index] = '\0'; // Null terminátor
+    return index;
+}
+
+int draw_game_to_buffer(const Game *game, char *buffer, size_t size) {
+    // Mapa a predmety jedným prechodom políčok, had sa dokreslí cez svoje články
+    int row_length = game->width + 1;
+    int index = 0;
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            buffer[index++] = game_map_symbol(game, x, y);
+        }
+        buffer[index++] = '\n'; // Ukončenie riadku
+    }
+    for (int i = 0; i < game->snake.length; i++) {
+        char *cell = &buffer[game->snake.body[i].y * row_length + game->snake.body[i].x];
+        if (*cell == '.') *cell = 'O'; // Okraj, prekážka aj predmet majú prednosť
+    }
+
+    return game_draw_summary(game, buffer, index, size);
+}
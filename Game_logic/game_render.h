@@ -0,0 +1,30 @@
+#ifndef GAME_RENDER_H
+#define GAME_RENDER_H
+
+#include <stddef.h>
+#include "game_logic.h"
+#include "game_items.h"
+
+// Textový rámec hry: mapa s koncami riadkov a pod ňou súhrn. Vykresľuje ho server pre rámce
+// aj klient v lockstep režime, ktorý hru simuluje sám (game_lockstep.h).
+
+#define GAME_RENDER_SUMMARY_MAX 128 // Najdlhší súhrn pod mapou
+
+// Znak políčka mapy bez hada: okraj, prekážka alebo predmet.
+static inline char game_map_symbol(const Game *game, int x, int y) {
+    if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) {
+        return '#';
+    }
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) {
+        return '#';
+    }
+    return item_symbol(game->cells[y * game->width + x]);
+}
+
+// Dopíše súhrn (ovocie a dĺžka hry) od pozície index. Vráti novú dĺžku rámca.
+int game_draw_summary(const Game *game, char *buffer, int index, size_t size);
+
+// Vykreslí celú mapu so súhrnom. buffer má aspoň (width + 1) * height + GAME_RENDER_SUMMARY_MAX bajtov.
+int draw_game_to_buffer(const Game *game, char *buffer, size_t size);
+
+#endif // GAME_RENDER_H
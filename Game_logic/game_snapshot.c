@@ -0,0 +1,268 @@
+#include "game_snapshot.h"
+#include "game_hash.h"
+#include "game_items.h"
+#include "packed_snake.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t obstacle_bitset_size(int width, int height) {
+    return ((size_t)width * (size_t)height + 7) / 8;
+}
+
+static size_t body_size(int encoding, int length) {
+    return encoding == SNAPSHOT_BODY_PACKED ? packed_snake_serialized_size(length) : (size_t)length * sizeof(Point);
+}
+
+// Telo sa balí, ak sú články súvislé (v platnej hre vždy), inak sa uloží po bodoch.
+static int body_encoding(const Game *game, PackedSnake *packed) {
+    return packed_snake_pack(packed, &game->snake, game->width, game->height) == 0
+           ? SNAPSHOT_BODY_PACKED : SNAPSHOT_BODY_POINTS;
+}
+
+static int snapshot_flag_valid(int32_t flag) {
+    return flag == 0 || flag == 1;
+}
+
+static int item_total(const Game *game) {
+    return game->item_counts[ITEM_FRUIT] + game->item_counts[ITEM_SPEED] + game->item_counts[ITEM_SHRINK];
+}
+
+size_t game_snapshot_size(const Game *game) {
+    PackedSnake packed;
+    return sizeof(GameSnapshotHeader)
+           + body_size(body_encoding(game, &packed), game->snake.length)
+           + obstacle_bitset_size(game->width, game->height)
+           + (size_t)item_total(game) * sizeof(uint32_t);
+}
+
+size_t game_snapshot_write(const Game *game, void *buffer, size_t size) {
+    PackedSnake packed;
+    int encoding = body_encoding(game, &packed);
+    int items = item_total(game);
+    size_t needed = sizeof(GameSnapshotHeader) + body_size(encoding, game->snake.length)
+                    + obstacle_bitset_size(game->width, game->height) + (size_t)items * sizeof(uint32_t);
+    if (size < needed) return 0;
+
+    GameSnapshotHeader *header = buffer;
+    header->magic = SNAPSHOT_MAGIC;
+    header->version = SNAPSHOT_VERSION;
+    header->total_size = (uint32_t)needed;
+    header->width = game->width;
+    header->height = game->height;
+    header->mode = game->mode;
+    header->time_limit = game->time_limit;
+    header->world_type = game->world_type;
+    header->start_ms = game->start_ms;
+    header->pause_start_ms = game->pause_start_ms;
+    header->total_pause_ms = game->total_pause_ms;
+    header->state_hash = game_hash(game);
+    header->rng_state = game->rng_state;
+    header->snake_length = game->snake.length;
+    header->snake_direction = game->snake.direction;
+    header->snake_alive = game->snake.alive;
+    header->body_encoding = encoding;
+    header->item_count = items;
+    header->fruit_target = game->fruit_target;
+    header->fruits_eaten = game->fruits_eaten;
+    header->speed_ticks = game->speed_ticks;
+    header->spawn_counter = game->spawn_counter;
+    header->paused = game->player_status.paused;
+    header->active = game->player_status.active;
+    header->paused_message_sent = game->paused_message_sent;
+
+    unsigned char *cursor = (unsigned char *)buffer + sizeof(GameSnapshotHeader);
+    if (encoding == SNAPSHOT_BODY_PACKED) {
+        cursor += packed_snake_serialize(&packed, cursor);
+    } else {
+        memcpy(cursor, game->snake.body, (size_t)game->snake.length * sizeof(Point));
+        cursor += (size_t)game->snake.length * sizeof(Point);
+    }
+
+    // Prekážky ako bitová mapa: 1 bit na políčko namiesto int
+    memset(cursor, 0, obstacle_bitset_size(game->width, game->height));
+    if (game->obstacles) {
+        size_t bit = 0;
+        for (int y = 0; y < game->height; y++) {
+            const int *row = game->obstacles[y];
+            for (int x = 0; x < game->width; x++, bit++) {
+                if (row[x]) {
+                    cursor[bit >> 3] |= (unsigned char)(1u << (bit & 7));
+                }
+            }
+        }
+    }
+    cursor += obstacle_bitset_size(game->width, game->height);
+
+    // Predmety ako zoznam, mapa predmetov je väčšinou prázdna
+    size_t size_cells = (size_t)game->width * (size_t)game->height;
+    for (size_t cell = 0; cell < size_cells && items > 0; cell++) {
+        int item = game->cells[cell] & CELL_ITEM_MASK;
+        if (item == ITEM_NONE) continue;
+        uint32_t entry = (uint32_t)cell << 2 | (uint32_t)item;
+        memcpy(cursor, &entry, sizeof(entry));
+        cursor += sizeof(entry);
+        items--;
+    }
+
+    return needed;
+}
+
+int game_snapshot_restore(Game *game, const void *buffer, size_t size) {
+    return game_snapshot_restore_into(game, buffer, size, NULL, 0);
+}
+
+int game_snapshot_restore_into(Game *game, const void *buffer, size_t size, void *grid, size_t grid_capacity) {
+    if (size < sizeof(GameSnapshotHeader)) return -1;
+
+    const GameSnapshotHeader *header = buffer;
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION) return -1;
+    if (header->width <= 0 || header->height <= 0
+        || header->width > SNAPSHOT_MAX_DIMENSION || header->height > SNAPSHOT_MAX_DIMENSION
+        || header->snake_length < 1 || header->snake_length > MAX_SNAKE_LENGTH
+        || (header->body_encoding != SNAPSHOT_BODY_POINTS && header->body_encoding != SNAPSHOT_BODY_PACKED)) {
+        return -1;
+    }
+    if (header->snake_direction < 0 || header->snake_direction > 3
+        || !snapshot_flag_valid(header->snake_alive) || !snapshot_flag_valid(header->paused)
+        || !snapshot_flag_valid(header->active) || !snapshot_flag_valid(header->paused_message_sent)) {
+        return -1;
+    }
+
+    if (header->item_count < 0 || (int64_t)header->item_count > (int64_t)header->width * header->height) return -1;
+    size_t needed = sizeof(GameSnapshotHeader)
+                    + body_size(header->body_encoding, header->snake_length)
+                    + obstacle_bitset_size(header->width, header->height)
+                    + (size_t)header->item_count * sizeof(uint32_t);
+    if (header->total_size != needed || size < needed) return -1;
+
+    game->width = header->width;
+    game->height = header->height;
+    game->mode = header->mode;
+    game->time_limit = header->time_limit;
+    game->world_type = header->world_type;
+    game->start_ms = header->start_ms;
+    game->pause_start_ms = header->pause_start_ms;
+    game->total_pause_ms = header->total_pause_ms;
+    game->rng_state = header->rng_state;
+    game->snake.length = header->snake_length;
+    game->snake.direction = header->snake_direction;
+    game->snake.alive = header->snake_alive;
+    game->fruit_target = header->fruit_target;
+    game->fruits_eaten = header->fruits_eaten;
+    game->speed_ticks = header->speed_ticks;
+    game->spawn_counter = header->spawn_counter;
+    game->player_status.paused = header->paused;
+    game->player_status.active = header->active;
+    game->paused_message_sent = header->paused_message_sent;
+
+    const unsigned char *cursor = (const unsigned char *)buffer + sizeof(GameSnapshotHeader);
+    if (header->body_encoding == SNAPSHOT_BODY_PACKED) {
+        PackedSnake packed;
+        packed_snake_deserialize(&packed, cursor, header->snake_length, header->width, header->height);
+        packed.direction = (uint8_t)header->snake_direction;
+        packed.alive = (uint8_t)header->snake_alive;
+        packed_snake_unpack(&packed, &game->snake);
+    } else {
+        memcpy(game->snake.body, cursor, (size_t)header->snake_length * sizeof(Point));
+    }
+    cursor += body_size(header->body_encoding, header->snake_length);
+    for (int i = 0; i < game->snake.length; i++) {
+        Point body = game->snake.body[i];
+        if (body.x < 0 || body.x >= game->width || body.y < 0 || body.y >= game->height) return -1;
+    }
+
+    size_t grid_size = game_grid_size(game->width, game->height);
+    game->owns_grid = grid == NULL;
+    if (!grid) {
+        grid = malloc(grid_size);
+        if (!grid) return -1;
+    } else if (grid_capacity < grid_size) {
+        return -1;
+    }
+    game_grid_attach(game, grid);
+
+    size_t bit = 0;
+    for (int y = 0; y < game->height; y++) {
+        int *row = game->obstacles[y];
+        for (int x = 0; x < game->width; x++, bit++) {
+            row[x] = (cursor[bit >> 3] >> (bit & 7)) & 1;
+        }
+    }
+    cursor += obstacle_bitset_size(game->width, game->height);
+
+    size_t size_cells = (size_t)game->width * (size_t)game->height;
+    for (int i = 0; i < header->item_count; i++, cursor += sizeof(uint32_t)) {
+        uint32_t entry;
+        memcpy(&entry, cursor, sizeof(entry));
+        uint32_t cell = entry >> 2;
+        if (cell < size_cells) game->cells[cell] = (uint8_t)(entry & 3);
+    }
+    game_items_rebuild(game);
+
+    game_hash_rebuild(game);
+    if (game_hash(game) != header->state_hash) {
+        release_game(game); // Mriežku volajúceho len odpojí
+        return -1;
+    }
+    return 0;
+}
+
+int game_snapshot_save_file(const Game *game, const char *path) {
+    size_t size = game_snapshot_size(game);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        perror("Snapshot open failed");
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)size) < 0) {
+        perror("Snapshot ftruncate failed");
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Snapshot mmap failed");
+        return -1;
+    }
+
+    size_t written = game_snapshot_write(game, map, size);
+    munmap(map, size);
+    return written == size ? 0 : -1;
+}
+
+int game_snapshot_load_file(Game *game, const char *path) {
+    return game_snapshot_load_file_into(game, path, NULL, 0);
+}
+
+int game_snapshot_load_file_into(Game *game, const char *path, void *grid, size_t grid_capacity) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Snapshot open failed");
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(GameSnapshotHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Snapshot mmap failed");
+        return -1;
+    }
+
+    int result = game_snapshot_restore_into(game, map, (size_t)st.st_size, grid, grid_capacity);
+    munmap(map, (size_t)st.st_size);
+    return result;
+}
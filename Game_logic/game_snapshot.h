@@ -0,0 +1,70 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+#define SNAPSHOT_MAGIC 0x50414e53u // "SNAP"
+#define SNAPSHOT_VERSION 7
+#define SNAPSHOT_MAX_DIMENSION 4096 // Najväčší rozmer mapy, ktorý obnova prijme (pred alokáciou mriežky)
+
+#define SNAPSHOT_BODY_POINTS 0 // Telo ako length * Point
+#define SNAPSHOT_BODY_PACKED 1 // Telo ako hlava a 2-bitové smery článkov (packed_snake_serialize)
+
+// Hlavička plochého snapshotu. Za ňou nasleduje telo hada (podľa body_encoding),
+// bitová mapa prekážok (width * height bitov, zarovnaná na bajty) a item_count
+// predmetov ako uint32_t (index políčka << 2 | ITEM_*).
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;      // Veľkosť celého snapshotu v bajtoch
+    int32_t width;
+    int32_t height;
+    int32_t mode;
+    int32_t time_limit;
+    int32_t world_type;
+    int64_t start_ms;
+    int64_t pause_start_ms;
+    int64_t total_pause_ms;
+    uint64_t state_hash;      // game_hash pri zápise; obnovená hra sa s ním musí zhodovať
+    uint32_t rng_state;
+    int32_t snake_length;
+    int32_t snake_direction;
+    int32_t snake_alive;
+    int32_t body_encoding;    // SNAPSHOT_BODY_*
+    int32_t item_count;
+    int32_t fruit_target;
+    int32_t fruits_eaten;
+    int32_t speed_ticks;
+    int32_t spawn_counter;
+    int32_t paused;
+    int32_t active;
+    int32_t paused_message_sent;
+} GameSnapshotHeader;
+
+// Vráti počet bajtov potrebných na snapshot danej hry.
+size_t game_snapshot_size(const Game *game);
+
+// Zapíše snapshot do buffera. Vráti počet zapísaných bajtov alebo 0, ak je buffer malý.
+size_t game_snapshot_write(const Game *game, void *buffer, size_t size);
+
+// Obnoví hru zo snapshotu (alokuje mriežku prekážok). Vráti 0 pri úspechu, -1 pri chybe
+// (rozmer nad SNAPSHOT_MAX_DIMENSION, článok mimo mapy, neplatný smer alebo príznak, alebo
+// hash obnovenej hry sa líši od state_hash, t. j. snapshot je poškodený).
+int game_snapshot_restore(Game *game, const void *buffer, size_t size);
+
+// Ako game_snapshot_restore, ale mriežka prekážok sa rozloží do bloku grid volajúceho
+// (aspoň game_grid_size bajtov). Pri grid == NULL sa alokuje.
+int game_snapshot_restore_into(Game *game, const void *buffer, size_t size, void *grid, size_t grid_capacity);
+
+// Uloží snapshot do súboru cez mmap. Vráti 0 pri úspechu, -1 pri chybe.
+int game_snapshot_save_file(const Game *game, const char *path);
+
+// Namapuje súbor so snapshotom a obnoví z neho hru. Vráti 0 pri úspechu, -1 pri chybe.
+int game_snapshot_load_file(Game *game, const char *path);
+
+// Ako game_snapshot_load_file, mriežka prekážok ide do bloku grid (viď game_snapshot_restore_into).
+int game_snapshot_load_file_into(Game *game, const char *path, void *grid, size_t grid_capacity);
+
+#endif // GAME_SNAPSHOT_H
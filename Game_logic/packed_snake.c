@@ -0,0 +1,125 @@
+#include "packed_snake.h"
+#include <string.h>
+
+#define RING_MASK (PACKED_SNAKE_RING - 1)
+
+static const int move_dx[4] = {0, 1, 0, -1};
+static const int move_dy[4] = {-1, 0, 1, 0};
+
+static inline Point step_point(Point point, int direction, int width, int height) {
+    point.x = (point.x + move_dx[direction] + width) % width;
+    point.y = (point.y + move_dy[direction] + height) % height;
+    return point;
+}
+
+static inline int ring_get(const uint8_t *moves, int slot) {
+    slot &= RING_MASK;
+    return (moves[slot >> 2] >> ((slot & 3) * 2)) & 3;
+}
+
+static inline void ring_set(uint8_t *moves, int slot, int direction) {
+    slot &= RING_MASK;
+    int shift = (slot & 3) * 2;
+    moves[slot >> 2] = (uint8_t)((moves[slot >> 2] & ~(3 << shift)) | (direction << shift));
+}
+
+// Smer, ktorým sa z from prejde na to, alebo -1, ak políčka nesusedia.
+static int move_between(Point from, Point to, int width, int height) {
+    for (int direction = 0; direction < 4; direction++) {
+        if (points_equal(step_point(from, direction, width, height), to)) return direction;
+    }
+    return -1;
+}
+
+int packed_snake_pack(PackedSnake *packed, const Snake *snake, int width, int height) {
+    if (snake->length < 1 || snake->length > PACKED_SNAKE_RING || width > UINT16_MAX || height > UINT16_MAX) {
+        return -1;
+    }
+
+    memset(packed, 0, sizeof(*packed));
+    packed->head = snake->body[0];
+    packed->tail = snake->body[snake->length - 1];
+    packed->length = snake->length;
+    packed->width = (uint16_t)width;
+    packed->height = (uint16_t)height;
+    packed->direction = (uint8_t)snake->direction;
+    packed->alive = (uint8_t)snake->alive;
+    for (int i = 0; i + 1 < snake->length; i++) {
+        int direction = move_between(snake->body[i + 1], snake->body[i], width, height);
+        if (direction < 0) return -1;
+        ring_set(packed->moves, i, direction);
+    }
+    return 0;
+}
+
+void packed_snake_unpack(const PackedSnake *packed, Snake *snake) {
+    PackedSnakeIter iter;
+    packed_snake_iter_begin(packed, &iter);
+    do {
+        snake->body[iter.index] = iter.point;
+    } while (packed_snake_iter_next(packed, &iter));
+    snake->length = packed->length;
+    snake->direction = packed->direction;
+    snake->alive = packed->alive;
+}
+
+int packed_snake_advance(PackedSnake *packed, int direction, int grow) {
+    if (grow && packed->length >= PACKED_SNAKE_RING) return -1;
+
+    packed->head = step_point(packed->head, direction, packed->width, packed->height);
+    packed->head_slot = (uint8_t)((packed->head_slot - 1) & RING_MASK);
+    ring_set(packed->moves, packed->head_slot, direction);
+    if (grow) {
+        packed->length++;
+    } else {
+        // Smer posledného článku ukazuje, kam sa chvost posunie
+        int tail_move = ring_get(packed->moves, packed->head_slot + packed->length - 1);
+        packed->tail = step_point(packed->tail, tail_move, packed->width, packed->height);
+    }
+    return 0;
+}
+
+void packed_snake_iter_begin(const PackedSnake *packed, PackedSnakeIter *iter) {
+    iter->point = packed->head;
+    iter->index = 0;
+}
+
+int packed_snake_iter_next(const PackedSnake *packed, PackedSnakeIter *iter) {
+    if (iter->index + 1 >= packed->length) return 0;
+    // Článok za aktuálnym je o krok proti jeho smeru
+    int direction = ring_get(packed->moves, packed->head_slot + iter->index);
+    iter->point = step_point(iter->point, (direction + 2) % 4, packed->width, packed->height);
+    iter->index++;
+    return 1;
+}
+
+size_t packed_snake_serialized_size(int length) {
+    return sizeof(Point) + ((size_t)(length - 1) * 2 + 7) / 8;
+}
+
+size_t packed_snake_serialize(const PackedSnake *packed, uint8_t *out) {
+    size_t size = packed_snake_serialized_size(packed->length);
+    memcpy(out, &packed->head, sizeof(Point));
+    uint8_t *moves = out + sizeof(Point);
+    memset(moves, 0, size - sizeof(Point));
+    for (int i = 0; i + 1 < packed->length; i++) {
+        ring_set(moves, i, ring_get(packed->moves, packed->head_slot + i));
+    }
+    return size;
+}
+
+void packed_snake_deserialize(PackedSnake *packed, const uint8_t *in, int length, int width, int height) {
+    memset(packed, 0, sizeof(*packed));
+    memcpy(&packed->head, in, sizeof(Point));
+    packed->length = length;
+    packed->width = (uint16_t)width;
+    packed->height = (uint16_t)height;
+    memcpy(packed->moves, in + sizeof(Point), packed_snake_serialized_size(length) - sizeof(Point));
+
+    // Chvost sa dopočíta prechodom tela
+    PackedSnakeIter iter;
+    packed_snake_iter_begin(packed, &iter);
+    while (packed_snake_iter_next(packed, &iter)) {
+    }
+    packed->tail = iter.point;
+}
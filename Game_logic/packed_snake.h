@@ -0,0 +1,59 @@
+#ifndef PACKED_SNAKE_H
+#define PACKED_SNAKE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// Úsporná reprezentácia tela hada: iba hlava, chvost a pre každý článok 2-bitový smer
+// (0 hore, 1 vpravo, 2 dole, 3 vľavo ako v Snake.direction), ktorým sa z neho prejde
+// k predchádzajúcemu článku smerom k hlave. Smery sú v kruhovom bufferi, takže ťah hada
+// (nová hlava a posun chvosta) je O(1). Oproti Snake (bod na článok, 812 bajtov) zaberá
+// PackedSnake 60 bajtov a v snapshote telo zaberá 2 bity na článok namiesto 8 bajtov.
+// Súradnice sa počítajú modulo rozmer mapy, takže funguje aj prechod cez okraj.
+
+#define PACKED_SNAKE_RING 128 // Kapacita buffera smerov (mocnina dvoch >= MAX_SNAKE_LENGTH)
+
+typedef struct {
+    Point head;
+    Point tail;
+    int32_t length;
+    uint16_t width;          // Rozmer mapy pre prechod cez okraj
+    uint16_t height;
+    uint8_t direction;
+    uint8_t alive;
+    uint8_t head_slot;       // Pozícia smeru článku za hlavou v kruhovom bufferi
+    uint8_t moves[PACKED_SNAKE_RING / 4];
+} PackedSnake;
+
+// Iterátor cez články od hlavy k chvostu.
+typedef struct {
+    Point point;  // Aktuálny článok
+    int index;    // Jeho poradie (0 = hlava)
+} PackedSnakeIter;
+
+// Zbalí hada. Vráti -1, ak susedné články nie sú susedné políčka (telo sa nedá zakódovať).
+int packed_snake_pack(PackedSnake *packed, const Snake *snake, int width, int height);
+
+// Rozbalí hada do Snake (body[0 .. length - 1]).
+void packed_snake_unpack(const PackedSnake *packed, Snake *snake);
+
+// Posunie hlavu o jedno políčko smerom direction. Ak grow je 0, posunie sa aj chvost.
+// Vráti -1, ak by had prekročil kapacitu buffera.
+int packed_snake_advance(PackedSnake *packed, int direction, int grow);
+
+void packed_snake_iter_begin(const PackedSnake *packed, PackedSnakeIter *iter);
+
+// Prejde na ďalší článok. Vráti 0, ak už žiadny nie je.
+int packed_snake_iter_next(const PackedSnake *packed, PackedSnakeIter *iter);
+
+// Veľkosť zbaleného tela (hlava a smery všetkých článkov) v snapshote.
+size_t packed_snake_serialized_size(int length);
+
+// Zapíše hlavu a smery v poradí od hlavy. Vráti počet zapísaných bajtov.
+size_t packed_snake_serialize(const PackedSnake *packed, uint8_t *out);
+
+// Obnoví hada zo serializovaného tela dĺžky length (smer a stav hada nastaví volajúci).
+void packed_snake_deserialize(PackedSnake *packed, const uint8_t *in, int length, int width, int height);
+
+#endif // PACKED_SNAKE_H
@@ -0,0 +1,299 @@
+#include "snake_batch.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SNAKE_BATCH_X86 1
+#endif
+
+#define RING_MASK (SNAKE_BATCH_RING - 1)
+
+SnakeBatch *snake_batch_create(int count, int width, int height, int world_type) {
+    if (count <= 0 || width <= 0 || height <= 0) return NULL;
+
+    SnakeBatch *batch = calloc(1, sizeof(SnakeBatch));
+    if (!batch) return NULL;
+    batch->count = count;
+    batch->width = width;
+    batch->height = height;
+    batch->world_type = world_type;
+
+    // Polia sú zarovnané na 32 bajtov a zaokrúhlené na násobok 8 pre AVX2 načítania
+    size_t lanes = ((size_t)count + 7) & ~(size_t)7;
+    int32_t **columns[] = {&batch->head_x, &batch->head_y, &batch->direction, &batch->length,
+                           &batch->alive, &batch->body_start, &batch->next_x, &batch->next_y,
+                           &batch->out_of_bounds};
+    for (size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++) {
+        *columns[i] = aligned_alloc(32, lanes * sizeof(int32_t));
+        if (!*columns[i]) {
+            snake_batch_free(batch);
+            return NULL;
+        }
+        memset(*columns[i], 0, lanes * sizeof(int32_t));
+    }
+    batch->body_x = malloc((size_t)count * SNAKE_BATCH_RING * sizeof(int32_t));
+    batch->body_y = malloc((size_t)count * SNAKE_BATCH_RING * sizeof(int32_t));
+    batch->cells = calloc((size_t)count * width * height, 1);
+    if (!batch->body_x || !batch->body_y || !batch->cells) {
+        snake_batch_free(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+void snake_batch_free(SnakeBatch *batch) {
+    if (!batch) return;
+    free(batch->head_x);
+    free(batch->head_y);
+    free(batch->direction);
+    free(batch->length);
+    free(batch->alive);
+    free(batch->body_start);
+    free(batch->next_x);
+    free(batch->next_y);
+    free(batch->out_of_bounds);
+    free(batch->body_x);
+    free(batch->body_y);
+    free(batch->cells);
+    free(batch);
+}
+
+static inline int batch_ring(int index, int position) {
+    return index * SNAKE_BATCH_RING + (position & RING_MASK);
+}
+
+int snake_batch_load(SnakeBatch *batch, int index, const Game *game) {
+    if (index < 0 || index >= batch->count || game->width != batch->width
+        || game->height != batch->height || game->world_type != batch->world_type) {
+        return -1;
+    }
+
+    const Snake *snake = &game->snake;
+    batch->head_x[index] = snake->body[0].x;
+    batch->head_y[index] = snake->body[0].y;
+    batch->direction[index] = snake->direction;
+    batch->length[index] = snake->length;
+    batch->alive[index] = snake->alive;
+    batch->body_start[index] = 0;
+
+    // Aj článok za chvostom (body[length]) sa prenáša, move_snake ho tam necháva
+    int stored = snake->length < MAX_SNAKE_LENGTH ? snake->length + 1 : snake->length;
+    for (int i = 0; i < stored; i++) {
+        batch->body_x[batch_ring(index, i)] = snake->body[i].x;
+        batch->body_y[batch_ring(index, i)] = snake->body[i].y;
+    }
+
+    uint8_t *cells = snake_batch_cells(batch, index);
+    memset(cells, 0, (size_t)batch->width * batch->height);
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles) {
+        for (int y = 0; y < game->height; y++) {
+            for (int x = 0; x < game->width; x++) {
+                if (game->obstacles[y][x] == 1) cells[y * batch->width + x] = SNAKE_BATCH_OBSTACLE;
+            }
+        }
+    }
+    for (int i = 0; i < snake->length; i++) {
+        cells[snake->body[i].y * batch->width + snake->body[i].x]++;
+    }
+    return 0;
+}
+
+void snake_batch_place(SnakeBatch *batch, int index, Point head, int direction) {
+    uint8_t *cells = snake_batch_cells(batch, index);
+    int start = batch->body_start[index];
+    for (int i = 0; i < batch->length[index]; i++) {
+        int slot = batch_ring(index, start + i);
+        cells[batch->body_y[slot] * batch->width + batch->body_x[slot]] &= SNAKE_BATCH_OBSTACLE;
+    }
+
+    batch->head_x[index] = head.x;
+    batch->head_y[index] = head.y;
+    batch->direction[index] = direction;
+    batch->length[index] = 1;
+    batch->alive[index] = 1;
+    batch->body_start[index] = 0;
+    for (int i = 0; i < 2; i++) {
+        batch->body_x[batch_ring(index, i)] = head.x;
+        batch->body_y[batch_ring(index, i)] = head.y;
+    }
+    cells[head.y * batch->width + head.x]++;
+}
+
+void snake_batch_store(const SnakeBatch *batch, int index, Game *game) {
+    Snake *snake = &game->snake;
+    snake->direction = batch->direction[index];
+    snake->length = batch->length[index];
+    snake->alive = batch->alive[index];
+
+    int start = batch->body_start[index];
+    int stored = snake->length < MAX_SNAKE_LENGTH ? snake->length + 1 : snake->length;
+    for (int i = 0; i < stored; i++) {
+        snake->body[i].x = batch->body_x[batch_ring(index, start + i)];
+        snake->body[i].y = batch->body_y[batch_ring(index, start + i)];
+    }
+}
+
+void snake_batch_change_direction(SnakeBatch *batch, int index, int new_direction) {
+    if ((batch->direction[index] + 2) % 4 != new_direction) {
+        batch->direction[index] = new_direction;
+    }
+}
+
+void snake_batch_grow(SnakeBatch *batch, int index) {
+    int length = batch->length[index];
+    if (length >= MAX_SNAKE_LENGTH - 1) return;
+
+    // Starý chvost ostal v kruhovom bufferi hneď za telom
+    int tail = batch_ring(index, batch->body_start[index] + length);
+    snake_batch_cells(batch, index)[batch->body_y[tail] * batch->width + batch->body_x[tail]]++;
+    batch->length[index] = length + 1;
+}
+
+void snake_batch_shrink(SnakeBatch *batch, int index, int count) {
+    uint8_t *cells = snake_batch_cells(batch, index);
+    for (int i = 0; i < count && batch->length[index] > 1; i++) {
+        int tail = batch_ring(index, batch->body_start[index] + batch->length[index] - 1);
+        cells[batch->body_y[tail] * batch->width + batch->body_x[tail]]--;
+        batch->length[index]--;
+    }
+}
+
+// Vektorová fáza: nové pozície hláv a príznak výstupu z mapy pre hry [from, to).
+static void batch_heads_scalar(SnakeBatch *batch, int from, int to) {
+    int width = batch->width, height = batch->height;
+    int wrap = batch->world_type == WORLD_NO_OBSTACLES;
+    for (int i = from; i < to; i++) {
+        int d = batch->direction[i];
+        int x = batch->head_x[i] + (d == 1) - (d == 3);
+        int y = batch->head_y[i] + (d == 2) - (d == 0);
+        int outside = x < 0 || x >= width || y < 0 || y >= height;
+        if (wrap) {
+            x = x < 0 ? width - 1 : (x >= width ? 0 : x);
+            y = y < 0 ? height - 1 : (y >= height ? 0 : y);
+            outside = 0;
+        }
+        batch->next_x[i] = x;
+        batch->next_y[i] = y;
+        batch->out_of_bounds[i] = outside ? -1 : 0;
+    }
+}
+
+#ifdef SNAKE_BATCH_X86
+// SSE2 je súčasťou každého x86-64, blend sa skladá z and/andnot/or
+static int batch_heads_sse2(SnakeBatch *batch) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i up = _mm_set1_epi32(0), right = _mm_set1_epi32(1);
+    const __m128i down = _mm_set1_epi32(2), left = _mm_set1_epi32(3);
+    const __m128i max_x = _mm_set1_epi32(batch->width - 1), max_y = _mm_set1_epi32(batch->height - 1);
+    int wrap = batch->world_type == WORLD_NO_OBSTACLES;
+    int i = 0;
+    for (; i + 4 <= batch->count; i += 4) {
+        __m128i d = _mm_load_si128((const __m128i *)(batch->direction + i));
+        // Porovnanie dáva -1 pre pravdu: dx = (d == 1) - (d == 3) = cmp3 - cmp1
+        __m128i dx = _mm_sub_epi32(_mm_cmpeq_epi32(d, left), _mm_cmpeq_epi32(d, right));
+        __m128i dy = _mm_sub_epi32(_mm_cmpeq_epi32(d, up), _mm_cmpeq_epi32(d, down));
+        __m128i x = _mm_add_epi32(_mm_load_si128((const __m128i *)(batch->head_x + i)), dx);
+        __m128i y = _mm_add_epi32(_mm_load_si128((const __m128i *)(batch->head_y + i)), dy);
+        __m128i below_x = _mm_cmpgt_epi32(zero, x), above_x = _mm_cmpgt_epi32(x, max_x);
+        __m128i below_y = _mm_cmpgt_epi32(zero, y), above_y = _mm_cmpgt_epi32(y, max_y);
+        __m128i outside;
+        if (wrap) {
+            x = _mm_or_si128(_mm_andnot_si128(below_x, x), _mm_and_si128(below_x, max_x));
+            x = _mm_andnot_si128(above_x, x);
+            y = _mm_or_si128(_mm_andnot_si128(below_y, y), _mm_and_si128(below_y, max_y));
+            y = _mm_andnot_si128(above_y, y);
+            outside = zero;
+        } else {
+            outside = _mm_or_si128(_mm_or_si128(below_x, above_x), _mm_or_si128(below_y, above_y));
+        }
+        _mm_store_si128((__m128i *)(batch->next_x + i), x);
+        _mm_store_si128((__m128i *)(batch->next_y + i), y);
+        _mm_store_si128((__m128i *)(batch->out_of_bounds + i), outside);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static int batch_heads_avx2(SnakeBatch *batch) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i up = _mm256_set1_epi32(0), right = _mm256_set1_epi32(1);
+    const __m256i down = _mm256_set1_epi32(2), left = _mm256_set1_epi32(3);
+    const __m256i max_x = _mm256_set1_epi32(batch->width - 1), max_y = _mm256_set1_epi32(batch->height - 1);
+    int wrap = batch->world_type == WORLD_NO_OBSTACLES;
+    int i = 0;
+    for (; i + 8 <= batch->count; i += 8) {
+        __m256i d = _mm256_load_si256((const __m256i *)(batch->direction + i));
+        __m256i dx = _mm256_sub_epi32(_mm256_cmpeq_epi32(d, left), _mm256_cmpeq_epi32(d, right));
+        __m256i dy = _mm256_sub_epi32(_mm256_cmpeq_epi32(d, up), _mm256_cmpeq_epi32(d, down));
+        __m256i x = _mm256_add_epi32(_mm256_load_si256((const __m256i *)(batch->head_x + i)), dx);
+        __m256i y = _mm256_add_epi32(_mm256_load_si256((const __m256i *)(batch->head_y + i)), dy);
+        __m256i below_x = _mm256_cmpgt_epi32(zero, x), above_x = _mm256_cmpgt_epi32(x, max_x);
+        __m256i below_y = _mm256_cmpgt_epi32(zero, y), above_y = _mm256_cmpgt_epi32(y, max_y);
+        __m256i outside;
+        if (wrap) {
+            x = _mm256_blendv_epi8(x, max_x, below_x);
+            x = _mm256_andnot_si256(above_x, x);
+            y = _mm256_blendv_epi8(y, max_y, below_y);
+            y = _mm256_andnot_si256(above_y, y);
+            outside = zero;
+        } else {
+            outside = _mm256_or_si256(_mm256_or_si256(below_x, above_x), _mm256_or_si256(below_y, above_y));
+        }
+        _mm256_store_si256((__m256i *)(batch->next_x + i), x);
+        _mm256_store_si256((__m256i *)(batch->next_y + i), y);
+        _mm256_store_si256((__m256i *)(batch->out_of_bounds + i), outside);
+    }
+    return i;
+}
+#endif
+
+static void batch_heads(SnakeBatch *batch) {
+    int done = 0;
+#ifdef SNAKE_BATCH_X86
+    static int has_avx2 = -1;
+    if (has_avx2 < 0) {
+        has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    done = has_avx2 ? batch_heads_avx2(batch) : batch_heads_sse2(batch);
+#endif
+    batch_heads_scalar(batch, done, batch->count); // Zvyšok, ktorý sa nezmestil do vektora
+}
+
+void snake_batch_step(SnakeBatch *batch, uint8_t *results) {
+    batch_heads(batch);
+
+    // Skalárna fáza: prekážky, posun tela a kolízia cez mriežku obsadenosti
+    int width = batch->width;
+    for (int i = 0; i < batch->count; i++) {
+        results[i] = 0;
+        if (!batch->alive[i]) continue;
+
+        int x = batch->next_x[i], y = batch->next_y[i];
+        uint8_t *cells = snake_batch_cells(batch, i);
+        if (batch->out_of_bounds[i] || (cells[y * width + x] & SNAKE_BATCH_OBSTACLE)) {
+            batch->alive[i] = 0;
+            continue;
+        }
+
+        // Chvost opúšťa telo (ostáva za ním pre prípadné predĺženie), nová hlava pribúda
+        int length = batch->length[i];
+        int tail = batch_ring(i, batch->body_start[i] + length - 1);
+        cells[batch->body_y[tail] * width + batch->body_x[tail]]--;
+        int start = (batch->body_start[i] - 1) & RING_MASK;
+        batch->body_start[i] = start;
+        batch->body_x[batch_ring(i, start)] = x;
+        batch->body_y[batch_ring(i, start)] = y;
+        batch->head_x[i] = x;
+        batch->head_y[i] = y;
+
+        uint8_t *cell = &cells[y * width + x];
+        int collided = (*cell & ~SNAKE_BATCH_OBSTACLE) != 0;
+        (*cell)++;
+        if (collided) {
+            batch->alive[i] = 0;
+            continue;
+        }
+        results[i] = 1;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SNAKE_BATCH_H
+#define SNAKE_BATCH_H
+
+#include <stdint.h>
+#include "game_logic.h"
+
+// Dávkový krok mnohých nezávislých hier rovnakého rozmeru (tréning botov, hromadná simulácia).
+// Hlavy, smery, dĺžky a príznaky života sú uložené ako štruktúra polí (SoA), takže nové
+// pozície hláv všetkých hier sa počítajú jednou vektorovou slučkou (AVX2, SSE2 alebo skalárne).
+// Telo každého hada je kruhový buffer a mriežka obsadenosti nahrádza prechádzanie tela
+// pri kolízii. Výsledok kroku aj stav hada sa presne zhodujú s move_snake.
+
+#define SNAKE_BATCH_RING 128 // Kapacita kruhového buffera tela (mocnina dvoch > MAX_SNAKE_LENGTH)
+#define SNAKE_BATCH_OBSTACLE 0x80 // Bit prekážky v bajte políčka, nižšie bity sú počet článkov hada
+
+typedef struct {
+    int count;          // Počet hier v dávke
+    int width;
+    int height;
+    int world_type;     // Spoločný typ sveta všetkých hier
+
+    int32_t *head_x;    // [count]
+    int32_t *head_y;
+    int32_t *direction;
+    int32_t *length;
+    int32_t *alive;
+    int32_t *body_start; // Index hlavy v kruhovom bufferi tela
+    int32_t *next_x;     // Pracovné polia vektorovej fázy
+    int32_t *next_y;
+    int32_t *out_of_bounds;
+    int32_t *body_x;     // [count * SNAKE_BATCH_RING]
+    int32_t *body_y;
+    uint8_t *cells;      // [count * width * height] prekážka a obsadenosť hadom
+} SnakeBatch;
+
+// Mriežka políčok hry index (width * height bajtov, riadok po riadku).
+static inline uint8_t *snake_batch_cells(const SnakeBatch *batch, int index) {
+    return batch->cells + (size_t)index * batch->width * batch->height;
+}
+
+// Alokuje dávku pre count hier s rozmerom width x height. Pri chybe vráti NULL.
+SnakeBatch *snake_batch_create(int count, int width, int height, int world_type);
+void snake_batch_free(SnakeBatch *batch);
+
+// Prevezme hada a prekážky hry do pozície index. Vráti -1, ak rozmer alebo typ sveta nesedí.
+int snake_batch_load(SnakeBatch *batch, int index, const Game *game);
+
+// Nahradí hada v pozícii index novým hadom dĺžky 1 (prekážky ostávajú, bez prechodu mriežkou).
+void snake_batch_place(SnakeBatch *batch, int index, Point head, int direction);
+
+// Zapíše stav hada z pozície index späť do hry (ako by na ňu bežal move_snake).
+void snake_batch_store(const SnakeBatch *batch, int index, Game *game);
+
+// Rovnaké pravidlá ako change_direction (zákaz otočenia o 180 stupňov).
+void snake_batch_change_direction(SnakeBatch *batch, int index, int new_direction);
+
+// Predĺži hada o jeden článok (na mieste starého chvosta), ako po zjedení ovocia.
+void snake_batch_grow(SnakeBatch *batch, int index);
+
+// Skráti hada o count článkov (ostane aspoň hlava), ako game_shrink_snake.
+void snake_batch_shrink(SnakeBatch *batch, int index, int count);
+
+// Posunie všetky hady o jeden krok. results[i] je návratová hodnota move_snake pre hru i
+// (pozastavené hry sa do dávky nevkladajú, pauzu rieši volajúci).
+void snake_batch_step(SnakeBatch *batch, uint8_t *results);
+
+#endif // SNAKE_BATCH_H
@@ -0,0 +1,172 @@
+#include "snake_env.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FRUIT_RANDOM_TRIES 64 // Potom sa voľné políčko hľadá postupne
+
+static inline void plane_set(uint8_t *plane, int bit) {
+    plane[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+}
+
+SnakeEnv *snake_env_create(int count, int width, int height, int world_type, int max_steps, uint32_t seed) {
+    if (width < 3 || height < 3) return NULL; // Ovocie potrebuje aspoň jedno vnútorné políčko
+
+    SnakeEnv *env = calloc(1, sizeof(SnakeEnv));
+    if (!env) return NULL;
+    env->max_steps = max_steps;
+    env->plane_bytes = ((size_t)width * height + 7) / 8;
+    env->batch = snake_batch_create(count, width, height, world_type);
+    env->games = calloc((size_t)count, sizeof(Game));
+    env->fruits = calloc((size_t)count, sizeof(Point));
+    env->steps = calloc((size_t)count, sizeof(int));
+    env->obstacle_planes = calloc((size_t)count, env->plane_bytes);
+    env->results = malloc((size_t)count);
+    if (!env->batch || !env->games || !env->fruits || !env->steps || !env->obstacle_planes || !env->results) {
+        snake_env_free(env);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        // Každé prostredie má vlastné semeno, nulu xorshift nepripúšťa
+        uint32_t env_seed = seed + (uint32_t)i * 0x9e3779b9u;
+        initialize_game_seeded(&env->games[i], width, height, STANDARD, 0, world_type, env_seed ? env_seed : 1);
+        if (!env->games[i].obstacles) {
+            snake_env_free(env);
+            return NULL;
+        }
+        snake_batch_load(env->batch, i, &env->games[i]); // Prekážky sa do mriežky prenesú raz
+        uint8_t *plane = env->obstacle_planes + (size_t)i * env->plane_bytes;
+        if (world_type == WORLD_WITH_OBSTACLES) {
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    if (env->games[i].obstacles[y][x] == 1) plane_set(plane, y * width + x);
+                }
+            }
+        }
+        snake_env_reset(env, i);
+    }
+    return env;
+}
+
+void snake_env_free(SnakeEnv *env) {
+    if (!env) return;
+    if (env->games && env->batch) {
+        for (int i = 0; i < env->batch->count; i++) {
+            release_game(&env->games[i]);
+        }
+    }
+    snake_batch_free(env->batch);
+    free(env->games);
+    free(env->fruits);
+    free(env->steps);
+    free(env->obstacle_planes);
+    free(env->results);
+    free(env);
+}
+
+size_t snake_env_observation_size(const SnakeEnv *env) {
+    return SNAKE_ENV_PLANES * env->plane_bytes;
+}
+
+// Rovnaké pravidlá ako generate_fruit (nie na okraji, prekážke ani hadovi), ale voľnosť políčka
+// sa zisťuje z mriežky dávky. Ak je plocha plná, ovocie sa neumiestni (x = -1).
+static void env_place_fruit(SnakeEnv *env, int index) {
+    Game *game = &env->games[index];
+    const uint8_t *cells = snake_batch_cells(env->batch, index);
+    int width = game->width, height = game->height;
+
+    for (int attempt = 0; attempt < FRUIT_RANDOM_TRIES; attempt++) {
+        int x = (int)(game_rand(game) % (uint32_t)width);
+        int y = (int)(game_rand(game) % (uint32_t)height);
+        if (x == 0 || x == width - 1 || y == 0 || y == height - 1) continue;
+        if (cells[y * width + x] == 0) {
+            env->fruits[index] = (Point){x, y};
+            return;
+        }
+    }
+
+    // Plocha je takmer plná, prehľadá sa od náhodného miesta
+    int inner = (width - 2) * (height - 2);
+    int offset = (int)(game_rand(game) % (uint32_t)inner);
+    for (int k = 0; k < inner; k++) {
+        int cell = (offset + k) % inner;
+        int x = 1 + cell % (width - 2), y = 1 + cell / (width - 2);
+        if (cells[y * width + x] == 0) {
+            env->fruits[index] = (Point){x, y};
+            return;
+        }
+    }
+    env->fruits[index] = (Point){-1, -1};
+}
+
+void snake_env_reset(SnakeEnv *env, int index) {
+    Game *game = &env->games[index];
+    snake_batch_place(env->batch, index, (Point){game->width / 2, game->height / 2}, 1);
+    env_place_fruit(env, index);
+    env->steps[index] = 0;
+}
+
+void snake_env_reset_all(SnakeEnv *env) {
+    for (int i = 0; i < env->batch->count; i++) {
+        snake_env_reset(env, i);
+    }
+}
+
+void snake_env_step(SnakeEnv *env, const uint8_t *actions, int8_t *rewards, uint8_t *dones) {
+    SnakeBatch *batch = env->batch;
+    for (int i = 0; i < batch->count; i++) {
+        if (actions[i] < SNAKE_ENV_NOOP) snake_batch_change_direction(batch, i, actions[i]);
+    }
+
+    snake_batch_step(batch, env->results);
+
+    for (int i = 0; i < batch->count; i++) {
+        int reward = 0, done = SNAKE_ENV_RUNNING;
+        if (!env->results[i]) {
+            reward = -1;
+            done = SNAKE_ENV_TERMINATED;
+        } else {
+            if (batch->head_x[i] == env->fruits[i].x && batch->head_y[i] == env->fruits[i].y) {
+                snake_batch_grow(batch, i);
+                env_place_fruit(env, i);
+                reward = 1;
+            }
+            if (env->max_steps > 0 && ++env->steps[i] >= env->max_steps) {
+                done = SNAKE_ENV_TRUNCATED;
+            }
+        }
+        if (rewards) rewards[i] = (int8_t)reward;
+        if (dones) dones[i] = (uint8_t)done;
+        if (done != SNAKE_ENV_RUNNING) snake_env_reset(env, i);
+    }
+}
+
+void snake_env_observe_one(const SnakeEnv *env, int index, uint8_t *out) {
+    const SnakeBatch *batch = env->batch;
+    size_t plane_bytes = env->plane_bytes;
+    int width = batch->width;
+
+    memset(out, 0, SNAKE_ENV_PLANE_OBSTACLES * plane_bytes);
+    uint8_t *body = out + SNAKE_ENV_PLANE_BODY * plane_bytes;
+    int start = batch->body_start[index];
+    const int32_t *body_x = batch->body_x + (size_t)index * SNAKE_BATCH_RING;
+    const int32_t *body_y = batch->body_y + (size_t)index * SNAKE_BATCH_RING;
+    for (int k = 1; k < batch->length[index]; k++) {
+        int slot = (start + k) & (SNAKE_BATCH_RING - 1);
+        plane_set(body, body_y[slot] * width + body_x[slot]);
+    }
+    plane_set(out + SNAKE_ENV_PLANE_HEAD * plane_bytes, batch->head_y[index] * width + batch->head_x[index]);
+    Point fruit = env->fruits[index];
+    if (fruit.x >= 0) {
+        plane_set(out + SNAKE_ENV_PLANE_FRUIT * plane_bytes, fruit.y * width + fruit.x);
+    }
+    memcpy(out + SNAKE_ENV_PLANE_OBSTACLES * plane_bytes,
+           env->obstacle_planes + (size_t)index * plane_bytes, plane_bytes);
+}
+
+void snake_env_observe(const SnakeEnv *env, uint8_t *out) {
+    size_t size = snake_env_observation_size(env);
+    for (int i = 0; i < env->batch->count; i++) {
+        snake_env_observe_one(env, i, out + (size_t)i * size);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "snake_batch.h"
+
+// Rozhranie knižnice libsnake pre trénovanie agentov: mnoho paralelných prostredí rovnakého
+// rozmeru, ktoré sa krokujú spolu nad SnakeBatch. Kroky ani pozorovania nič nealokujú,
+// všetky výstupy sa zapisujú do bufferov volajúceho.
+//
+// Pozorovanie jedného prostredia sú SNAKE_ENV_PLANES bitové roviny po width * height bitov
+// (každá zarovnaná na celé bajty), bit políčka (x, y) má index y * width + x, v bajte od
+// najnižšieho bitu. Roviny idú v poradí telo (bez hlavy), hlava, ovocie, prekážky.
+
+#define SNAKE_ENV_PLANES 4
+#define SNAKE_ENV_PLANE_BODY 0
+#define SNAKE_ENV_PLANE_HEAD 1
+#define SNAKE_ENV_PLANE_FRUIT 2
+#define SNAKE_ENV_PLANE_OBSTACLES 3
+
+#define SNAKE_ENV_NOOP 4 // Akcia bez zmeny smeru (0 - 3 sú smery ako v change_direction)
+
+#define SNAKE_ENV_RUNNING 0
+#define SNAKE_ENV_TERMINATED 1 // Had narazil, epizóda skončila
+#define SNAKE_ENV_TRUNCATED 2  // Epizóda dosiahla max_steps
+
+typedef struct {
+    SnakeBatch *batch;
+    Game *games;            // [count] prekážky a stav generátora každého prostredia
+    Point *fruits;          // [count] ovocie každého prostredia (x = -1, ak nie je kam ho dať)
+    int max_steps;          // 0 = epizóda nemá limit ťahov
+    int *steps;             // [count] ťahy v aktuálnej epizóde
+    size_t plane_bytes;     // Veľkosť jednej roviny v bajtoch
+    uint8_t *obstacle_planes; // [count * plane_bytes] predpočítaná rovina prekážok
+    uint8_t *results;       // [count] pracovné pole pre snake_batch_step
+} SnakeEnv;
+
+// Vytvorí count prostredí. Rozloženie prekážok sa vygeneruje zo semena raz a platí pre všetky
+// epizódy daného prostredia. Pri chybe vráti NULL.
+SnakeEnv *snake_env_create(int count, int width, int height, int world_type, int max_steps, uint32_t seed);
+void snake_env_free(SnakeEnv *env);
+
+// Počet bajtov pozorovania jedného prostredia.
+size_t snake_env_observation_size(const SnakeEnv *env);
+
+// Začne novú epizódu prostredia index (had v strede, smer vpravo, nové ovocie).
+void snake_env_reset(SnakeEnv *env, int index);
+void snake_env_reset_all(SnakeEnv *env);
+
+// Vykoná jeden ťah vo všetkých prostrediach. actions[i] je smer 0 - 3 alebo SNAKE_ENV_NOOP,
+// rewards[i] je +1 za ovocie, -1 za náraz, inak 0, dones[i] je SNAKE_ENV_*. Skončené
+// prostredia sa hneď resetujú, takže ďalšie pozorovanie patrí už novej epizóde.
+// rewards aj dones môžu byť NULL.
+void snake_env_step(SnakeEnv *env, const uint8_t *actions, int8_t *rewards, uint8_t *dones);
+
+// Zapíše pozorovania všetkých prostredí za sebou (count * snake_env_observation_size bajtov).
+void snake_env_observe(const SnakeEnv *env, uint8_t *out);
+
+// Zapíše pozorovanie jedného prostredia.
+void snake_env_observe_one(const SnakeEnv *env, int index, uint8_t *out);
+
+#endif // SNAKE_ENV_H
@@ -0,0 +1,160 @@
+#include "trace.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// Kruhový buffer jedného vlákna. Zapisuje doň len vlastník, čítač (výpis) ho len kopíruje.
+typedef struct TraceRing {
+    TraceEvent events[TRACE_RING_SIZE];
+    atomic_uint_fast64_t head; // Počet doteraz zapísaných udalostí
+    atomic_int in_use;         // 1, ak buffer patrí živému vláknu
+    struct TraceRing *next;
+} TraceRing;
+
+static TraceRing *trace_rings = NULL; // Zoznam všetkých bufferov (aj uvoľnených na znovupoužitie)
+static pthread_mutex_t trace_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t trace_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+static atomic_int trace_next_tid = 1;
+static volatile sig_atomic_t trace_dump_requested = 0;
+
+static _Thread_local TraceRing *trace_local_ring = NULL;
+static _Thread_local int trace_local_tid = 0;
+static _Thread_local int trace_local_room = -1;
+
+// Pri ukončení vlákna sa buffer vráti do zoznamu na znovupoužitie (udalosti v ňom ostanú).
+static void trace_release_ring(void *ring) {
+    atomic_store(&((TraceRing *)ring)->in_use, 0);
+}
+
+static void trace_create_key(void) {
+    pthread_key_create(&trace_key, trace_release_ring);
+}
+
+static TraceRing *trace_acquire_ring(void) {
+    pthread_once(&trace_key_once, trace_create_key);
+
+    pthread_mutex_lock(&trace_rings_mutex);
+    TraceRing *ring = trace_rings;
+    while (ring) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&ring->in_use, &expected, 1)) {
+            break;
+        }
+        ring = ring->next;
+    }
+    if (!ring) {
+        ring = calloc(1, sizeof(TraceRing));
+        if (ring) {
+            atomic_init(&ring->head, 0);
+            atomic_init(&ring->in_use, 1);
+            ring->next = trace_rings;
+            trace_rings = ring;
+        }
+    }
+    pthread_mutex_unlock(&trace_rings_mutex);
+
+    if (ring) {
+        pthread_setspecific(trace_key, ring);
+    }
+    trace_local_tid = atomic_fetch_add(&trace_next_tid, 1);
+    return ring;
+}
+
+uint64_t trace_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void trace_set_room(int room) {
+    trace_local_room = room;
+}
+
+void trace_record(const char *name, uint64_t start_us, uint64_t end_us) {
+    TraceRing *ring = trace_local_ring;
+    if (!ring) {
+        ring = trace_local_ring = trace_acquire_ring();
+        if (!ring) return;
+    }
+
+    uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent *event = &ring->events[head & (TRACE_RING_SIZE - 1)];
+    event->name = name;
+    event->room = trace_local_room;
+    event->tid = trace_local_tid;
+    event->start_us = start_us;
+    event->dur_us = end_us - start_us;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static void trace_signal_handler(int sig) {
+    (void)sig;
+    trace_dump_requested = 1;
+}
+
+void trace_install_signal_handler(void) {
+    struct sigaction sa = {0};
+    sa.sa_handler = trace_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+void trace_poll(void) {
+    if (!trace_dump_requested) return;
+    trace_dump_requested = 0;
+
+    const char *path = getenv("SNAKE_TRACE_FILE");
+    trace_dump(path ? path : TRACE_DEFAULT_FILE);
+}
+
+int trace_dump(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror("trace_dump: fopen failed");
+        return -1;
+    }
+
+    TraceEvent *copy = malloc(sizeof(TraceEvent) * TRACE_RING_SIZE);
+    if (!copy) {
+        fclose(out);
+        return -1;
+    }
+
+    fprintf(out, "{\"traceEvents\":[\n");
+    int first = 1;
+    int pid = (int)getpid();
+
+    pthread_mutex_lock(&trace_rings_mutex);
+    for (TraceRing *ring = trace_rings; ring; ring = ring->next) {
+        uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint_fast64_t begin = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        for (uint_fast64_t i = begin; i < head; i++) {
+            copy[i - begin] = ring->events[i & (TRACE_RING_SIZE - 1)];
+        }
+
+        // Udalosti, ktoré vlastník medzičasom prepísal (alebo práve prepisuje), zahodíme.
+        uint_fast64_t head_after = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint_fast64_t valid_from = head_after + 1 > TRACE_RING_SIZE ? head_after + 1 - TRACE_RING_SIZE : 0;
+        for (uint_fast64_t i = begin > valid_from ? begin : valid_from; i < head; i++) {
+            const TraceEvent *event = &copy[i - begin];
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,"
+                         "\"pid\":%d,\"tid\":%d,\"args\":{\"room\":%d}}",
+                    first ? "" : ",\n", event->name,
+                    (unsigned long long)event->start_us, (unsigned long long)event->dur_us,
+                    pid, event->tid, event->room);
+            first = 0;
+        }
+    }
+    pthread_mutex_unlock(&trace_rings_mutex);
+
+    fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    free(copy);
+    fclose(out);
+    return 0;
+}
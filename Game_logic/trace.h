@@ -0,0 +1,51 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Počet udalostí v kruhovom bufferi jedného vlákna (mocnina dvoch).
+#define TRACE_RING_SIZE 8192
+// Predvolený súbor pre výpis, ak nie je nastavená premenná SNAKE_TRACE_FILE.
+#define TRACE_DEFAULT_FILE "snake_trace.json"
+
+// Jedna ukončená fáza (Chrome trace udalosť typu "X").
+typedef struct {
+    const char *name; // Názov fázy (reťazcový literál)
+    int room;         // Identifikátor miestnosti, v ktorej fáza bežala
+    int tid;          // Poradové číslo vlákna, ktoré udalosť zapísalo
+    uint64_t start_us; // Začiatok fázy v mikrosekundách (CLOCK_MONOTONIC)
+    uint64_t dur_us;   // Trvanie fázy v mikrosekundách
+} TraceEvent;
+
+// Aktuálny čas v mikrosekundách (CLOCK_MONOTONIC).
+uint64_t trace_now_us(void);
+
+// Nastaví miestnosť, ku ktorej sa priradia ďalšie udalosti volajúceho vlákna.
+void trace_set_room(int room);
+
+// Zapíše udalosť do kruhového buffera volajúceho vlákna (bez zámkov).
+void trace_record(const char *name, uint64_t start_us, uint64_t end_us);
+
+// Nainštaluje obsluhu SIGUSR1, ktorá vyžiada výpis trasovania.
+void trace_install_signal_handler(void);
+
+// Ak bol výpis vyžiadaný signálom, vykoná ho. Volá sa z vlákien mimo signál handlera.
+void trace_poll(void);
+
+// Vypíše všetky buffery vo formáte Chrome/Perfetto trace JSON. Vráti 0 pri úspechu.
+int trace_dump(const char *path);
+
+// Makrá sa pri preklade bez SNAKE_TRACE úplne odstránia.
+#ifdef SNAKE_TRACE
+#define TRACE_ROOM(room) trace_set_room(room)
+#define TRACE_BEGIN(phase) uint64_t trace_start_##phase = trace_now_us()
+#define TRACE_END(phase) trace_record(#phase, trace_start_##phase, trace_now_us())
+#define TRACE_POLL() trace_poll()
+#else
+#define TRACE_ROOM(room) ((void)0)
+#define TRACE_BEGIN(phase) ((void)0)
+#define TRACE_END(phase) ((void)0)
+#define TRACE_POLL() ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,236 @@
+#include "protocol.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+static const char *message_type_names[] = {"UNKNOWN", "FRAME", "TOKEN", "STATUS", "END", "TRANSPORT",
+                                           "STATE", "STEP"};
+
+static MessageType message_type_from_name(const char *name) {
+    for (int i = 1; i < (int)(sizeof(message_type_names) / sizeof(message_type_names[0])); i++) {
+        if (strcmp(name, message_type_names[i]) == 0) {
+            return (MessageType)i;
+        }
+    }
+    return MSG_UNKNOWN;
+}
+
+int format_message_header(char *header, size_t cap, MessageType type, unsigned int tick, unsigned int ack,
+                          const FrameTiming *timing, unsigned long long hash, int length) {
+    if (type == MSG_FRAME || type == MSG_STEP) {
+        FrameTiming none = {0};
+        if (!timing) timing = &none;
+        return snprintf(header, cap, "%s tick=%u ack=%u at=%llu wait=%u build=%u hash=%016llx len=%d\n",
+                        message_type_names[type], tick, ack, timing->input_time_us, timing->input_wait_us,
+                        timing->build_us, hash, length);
+    }
+    if (type == MSG_STATE) {
+        return snprintf(header, cap, "%s tick=%u ack=%u hash=%016llx len=%d\n", message_type_names[type], tick,
+                        ack, hash, length);
+    }
+    return snprintf(header, cap, "%s len=%d\n", message_type_names[type], length);
+}
+
+int send_message(int fd, MessageType type, unsigned int tick, unsigned int ack,
+                 const char *payload, int length) {
+    char header[MESSAGE_HEADER_MAX];
+    int header_length = format_message_header(header, sizeof(header), type, tick, ack, NULL, 0, length);
+
+    struct iovec parts[2] = {
+        {header, (size_t)header_length},
+        {(void *)payload, (size_t)length}
+    };
+    size_t total = (size_t)header_length + (size_t)length;
+    ssize_t sent = writev(fd, parts, length > 0 ? 2 : 1);
+    return sent == (ssize_t)total ? 0 : -1;
+}
+
+int stream_reader_init(StreamReader *reader) {
+    reader->data = malloc(STREAM_READER_INITIAL_CAPACITY);
+    reader->size = 0;
+    reader->consumed = 0;
+    reader->capacity = reader->data ? STREAM_READER_INITIAL_CAPACITY : 0;
+    reader->max_size = 0;
+    return reader->data ? 0 : -1;
+}
+
+void stream_reader_free(StreamReader *reader) {
+    free(reader->data);
+    reader->data = NULL;
+    reader->size = reader->consumed = reader->capacity = 0;
+}
+
+void stream_reader_reset(StreamReader *reader) {
+    reader->size = 0;
+    reader->consumed = 0;
+}
+
+// Zdvojnásobí buffer (po neúspešnom init začne od STREAM_READER_INITIAL_CAPACITY), najviac
+// na max_size. Vráti 0, alebo -1 s EMSGSIZE, ak je buffer už na limite.
+static int stream_reader_grow(StreamReader *reader) {
+    size_t capacity = reader->capacity ? reader->capacity * 2 : STREAM_READER_INITIAL_CAPACITY;
+    if (reader->max_size > 0 && capacity > reader->max_size) {
+        if (reader->capacity >= reader->max_size) {
+            errno = EMSGSIZE;
+            return -1;
+        }
+        capacity = reader->max_size;
+    }
+    char *grown = realloc(reader->data, capacity);
+    if (!grown) return -1;
+    reader->data = grown;
+    reader->capacity = capacity;
+    return 0;
+}
+
+// Koľko bajtov smie buffer práve držať (capacity, ale najviac max_size).
+static size_t stream_reader_limit(const StreamReader *reader) {
+    return reader->max_size > 0 && reader->max_size < reader->capacity ? reader->max_size : reader->capacity;
+}
+
+int stream_reader_fill(StreamReader *reader, int fd) {
+    // Spracované bajty sa zahodia, aby sa buffer zbytočne nezväčšoval
+    if (reader->consumed > 0) {
+        memmove(reader->data, reader->data + reader->consumed, reader->size - reader->consumed);
+        reader->size -= reader->consumed;
+        reader->consumed = 0;
+    }
+    // Jeden bajt sa necháva voľný pre nulový terminátor riadku, takže plný buffer má size + 1 ==
+    // capacity; read s nulovou dĺžkou by volajúci považoval za zatvorené spojenie
+    if (reader->size + 1 >= stream_reader_limit(reader) && stream_reader_grow(reader) < 0) {
+        return -1;
+    }
+
+    ssize_t bytes_read = read(fd, reader->data + reader->size, stream_reader_limit(reader) - reader->size - 1);
+    if (bytes_read > 0) {
+        reader->size += (size_t)bytes_read;
+    }
+    return (int)bytes_read;
+}
+
+int stream_reader_append(StreamReader *reader, const char *data, size_t length) {
+    while (stream_reader_limit(reader) - reader->size < length + 1) {
+        if (stream_reader_grow(reader) < 0) return -1;
+    }
+    memcpy(reader->data + reader->size, data, length);
+    reader->size += length;
+    return 0;
+}
+
+int stream_reader_next_message(StreamReader *reader, Message *message) {
+    char *start = reader->data + reader->consumed;
+    size_t available = reader->size - reader->consumed;
+    char *newline = memchr(start, '\n', available);
+    if (!newline) {
+        return available >= MESSAGE_HEADER_MAX ? -1 : 0;
+    }
+
+    char header[MESSAGE_HEADER_MAX];
+    size_t header_length = (size_t)(newline - start);
+    if (header_length >= sizeof(header)) return -1;
+    memcpy(header, start, header_length);
+    header[header_length] = '\0';
+
+    memset(message, 0, sizeof(*message));
+    char *save = NULL;
+    char *token = strtok_r(header, " ", &save);
+    if (!token) return -1;
+    message->type = message_type_from_name(token);
+
+    // Neznáme kľúče sa ignorujú, aby sa hlavička dala rozširovať
+    while ((token = strtok_r(NULL, " ", &save)) != NULL) {
+        char *value = strchr(token, '=');
+        if (!value) continue;
+        *value++ = '\0';
+        if (strcmp(token, "tick") == 0) message->tick = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(token, "ack") == 0) message->ack = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(token, "len") == 0) message->length = atoi(value);
+        else if (strcmp(token, "at") == 0) message->timing.input_time_us = strtoull(value, NULL, 10);
+        else if (strcmp(token, "wait") == 0) message->timing.input_wait_us = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(token, "build") == 0) message->timing.build_us = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(token, "hash") == 0) message->hash = strtoull(value, NULL, 16);
+    }
+    if (message->length < 0) return -1;
+
+    size_t total = header_length + 1 + (size_t)message->length;
+    if (available < total) {
+        return 0; // Payload ešte neprišiel celý
+    }
+
+    message->payload = newline + 1;
+    reader->consumed += total;
+    return 1;
+}
+
+char *stream_reader_next_line(StreamReader *reader) {
+    char *start = reader->data + reader->consumed;
+    size_t available = reader->size - reader->consumed;
+    char *newline = memchr(start, '\n', available);
+    if (!newline) return NULL;
+
+    *newline = '\0';
+    if (newline > start && newline[-1] == '\r') {
+        newline[-1] = '\0';
+    }
+    reader->consumed += (size_t)(newline - start) + 1;
+    return start;
+}
+
+int build_frame_delta(char *out, size_t cap, unsigned int tick, unsigned int base, unsigned int ack,
+                      const FrameTiming *timing, const char *keyframe, const char *frame, int frame_length,
+                      int width, int height) {
+    int map_length = (width + 1) * height;
+    if (frame_length < map_length) return -1;
+
+    int length = snprintf(out, cap, "DELTA tick=%u base=%u ack=%u at=%llu wait=%u build=%u w=%d h=%d\n",
+                          tick, base, ack, timing->input_time_us, timing->input_wait_us, timing->build_us,
+                          width, height);
+    for (int i = 0; i < map_length; i++) {
+        if (frame[i] == keyframe[i] || frame[i] == '\n') continue;
+        length += snprintf(out + length, length < (int)cap ? cap - length : 0,
+                           "%d %d %c\n", i % (width + 1), i / (width + 1), frame[i]);
+        if (length >= (int)cap) return -1;
+    }
+    length += snprintf(out + length, length < (int)cap ? cap - length : 0,
+                       "HUD\n%.*s", frame_length - map_length, frame + map_length);
+    return length < (int)cap ? length : -1;
+}
+
+int parse_frame_delta_header(const char *datagram, unsigned int *tick, unsigned int *base,
+                             unsigned int *ack, FrameTiming *timing, int *width, int *height, const char **body) {
+    int consumed = 0;
+    if (sscanf(datagram, "DELTA tick=%u base=%u ack=%u at=%llu wait=%u build=%u w=%d h=%d\n%n",
+               tick, base, ack, &timing->input_time_us, &timing->input_wait_us, &timing->build_us,
+               width, height, &consumed) != 8 || consumed == 0) {
+        return -1;
+    }
+    if (*width <= 0 || *height <= 0) return -1;
+    *body = datagram + consumed;
+    return 0;
+}
+
+int apply_frame_delta(char *out, size_t cap, const char *keyframe, int width, int height, const char *body) {
+    int map_length = (width + 1) * height;
+    if ((size_t)map_length >= cap) return -1;
+    memcpy(out, keyframe, (size_t)map_length);
+
+    const char *line = body;
+    while (*line && strncmp(line, "HUD\n", 4) != 0) {
+        int x, y;
+        char cell;
+        if (sscanf(line, "%d %d %c", &x, &y, &cell) != 3 || x < 0 || x >= width || y < 0 || y >= height) {
+            return -1;
+        }
+        out[y * (width + 1) + x] = cell;
+        const char *next = strchr(line, '\n');
+        if (!next) return -1;
+        line = next + 1;
+    }
+    if (!*line) return -1;
+
+    int length = map_length + snprintf(out + map_length, cap - map_length, "%s", line + 4);
+    return length < (int)cap ? length : -1;
+}
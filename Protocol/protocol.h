@@ -0,0 +1,106 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+
+// Server -> klient: každá správa je riadok hlavičky "TYP kľúč=hodnota ... len=N\n",
+// za ktorým nasleduje presne N bajtov payloadu.
+// Klient -> server: každý príkaz je jeden riadok ukončený '\n'
+// ("move <seq> <smer> <čas>", "pause", "resume", "quit", nastavenia alebo "resume <token>").
+// <čas> je monotónny čas klienta v mikrosekundách pri odoslaní vstupu; rámec ho vráti
+// (at=) spolu s meraniami servera (wait=, build=, viď FrameTiming). FRAME, STATE a STEP nesú
+// aj hash=<16 hex číslic>, Zobristov hash stavu hry po ťahu (game_hash.h), 0 = neznámy.
+// Riadok "view <stĺpce> <riadky>" hlási rozmer terminálu; server potom posiela len výrez
+// mapy okolo hlavy hada s minimapou (rozmer mapy v rámci sa tým mení, viď w/h v DELTA).
+
+// UDP režim (vyjednaný riadkom "transport udp"): klient posiela vstupy ako datagramy
+// "IN <token> <seq> <smer> <čas> ..." s poslednými UDP_INPUT_REDUNDANCY vstupmi a server posiela
+// rámce ako rozdiely "DELTA tick=T base=K ack=A at=C wait=Q build=B w=W h=H\n" + riadky "x y znak\n" + "HUD\n" + súhrn
+// voči poslednému keyframe K. Keyframe (celá mapa) a riadiace príkazy idú spoľahlivo cez TCP.
+// Lokálny režim ("transport shm") je popísaný v shm_channel.h.
+// Lockstep režim ("transport lockstep", game_lockstep.h): server namiesto rámcov posiela
+// STATE so snapshotom hry (na začiatku, po pauze a na žiadosť "keyframe") a po každom ťahu
+// STEP s payloadom "<smer> <ms do ďalšieho ťahu>"; mapu si klient simuluje a vykresľuje sám.
+
+#define MESSAGE_HEADER_MAX 256
+#define UDP_INPUT_REDUNDANCY 4 // Počet posledných vstupov opakovaných v každom UDP pakete
+#define UDP_MAX_DATAGRAM 1400  // Väčší rozdiel sa namiesto UDP pošle ako keyframe cez TCP
+#define KEYFRAME_INTERVAL 20   // Po koľkých ťahoch sa v UDP režime posiela nový keyframe
+#define STREAM_READER_INITIAL_CAPACITY 4096
+
+typedef enum {
+    MSG_UNKNOWN = 0,
+    MSG_FRAME,  // Herná mapa jedného ťahu
+    MSG_TOKEN,  // Resume token pre návrat do hry
+    MSG_STATUS, // Textová informácia pre hráča
+    MSG_END,    // Koniec hry so záverečným skóre
+    MSG_TRANSPORT, // Odpoveď na vyjednanie prenosu ("udp <port>", "shm <meno>", "lockstep" alebo "tcp")
+    MSG_STATE,  // Snapshot hry po ťahu tick pre lockstep klienta (lockstep_write_state)
+    MSG_STEP    // Smer hada v ťahu tick (lockstep), ack a časy ako pri FRAME
+} MessageType;
+
+// Časy k rámcu pre meranie oneskorenia od stlačenia klávesu po vykreslenie.
+typedef struct {
+    unsigned long long input_time_us; // Čas klienta pri odoslaní vstupu ack (ozvena), 0 = neznámy
+    unsigned int input_wait_us;       // Od prijatia vstupu serverom po ťah, ktorý ho použil
+    unsigned int build_us;            // Od začiatku ťahu po odovzdanie rámca na odoslanie
+} FrameTiming;
+
+typedef struct {
+    MessageType type;
+    unsigned int tick;     // Poradové číslo ťahu (FRAME, STATE, STEP)
+    unsigned int ack;      // Sekvencia posledného vstupu použitého v tomto ťahu (FRAME, STATE, STEP)
+    FrameTiming timing;    // Časy vstupu a ťahu (FRAME, STEP)
+    unsigned long long hash; // Hash stavu hry po ťahu (FRAME, STATE, STEP), 0 = neznámy
+    int length;            // Dĺžka payloadu v bajtoch
+    const char *payload;   // Ukazuje do buffera čítača, platí do ďalšieho čítania
+} Message;
+
+// Buffer prúdu bajtov zo socketu, z ktorého sa vyberajú celé správy alebo riadky.
+typedef struct {
+    char *data;
+    size_t size;      // Počet platných bajtov v data
+    size_t consumed;  // Počet bajtov už vybraných správ/riadkov
+    size_t capacity;
+    size_t max_size;  // Najväčší buffer (0 = bez limitu); nad ním čítanie zlyhá s EMSGSIZE
+} StreamReader;
+
+// Zapíše hlavičku správy do header (aspoň MESSAGE_HEADER_MAX bajtov). Vráti jej dĺžku.
+// timing sa použije len pre FRAME a STEP a môže byť NULL, hash pre FRAME, STATE a STEP.
+int format_message_header(char *header, size_t cap, MessageType type, unsigned int tick, unsigned int ack,
+                          const FrameTiming *timing, unsigned long long hash, int length);
+
+// Odošle správu (hlavičku aj payload) jedným volaním writev. Vráti 0 pri úspechu, -1 pri chybe.
+int send_message(int fd, MessageType type, unsigned int tick, unsigned int ack,
+                 const char *payload, int length);
+
+int stream_reader_init(StreamReader *reader);
+void stream_reader_free(StreamReader *reader);
+void stream_reader_reset(StreamReader *reader);
+
+// Prečíta dostupné dáta zo socketu. Vráti počet prečítaných bajtov, 0 pri zatvorení, -1 pri chybe
+// (errno EMSGSIZE, ak by neukončená správa alebo riadok presiahli max_size).
+int stream_reader_fill(StreamReader *reader, int fd);
+
+// Pridá do buffera bajty prečítané inde (napr. spojenie odovzdané iným procesom).
+int stream_reader_append(StreamReader *reader, const char *data, size_t length);
+
+// Vyberie ďalšiu celú správu. Vráti 1, ak je k dispozícii, 0 ak treba čítať ďalej, -1 pri chybe formátu.
+int stream_reader_next_message(StreamReader *reader, Message *message);
+
+// Vyberie ďalší celý riadok (bez '\n', ukončený nulou). Vráti ukazovateľ alebo NULL.
+char *stream_reader_next_line(StreamReader *reader);
+
+// Zostaví UDP rozdiel rámca voči keyframe (oba majú mapu width x height s koncami riadkov
+// a za ňou súhrn). Vráti dĺžku datagramu alebo -1, ak sa nezmestí do cap.
+int build_frame_delta(char *out, size_t cap, unsigned int tick, unsigned int base, unsigned int ack,
+                      const FrameTiming *timing, const char *keyframe, const char *frame, int frame_length, int width, int height);
+
+// Prečíta hlavičku UDP rozdielu. Vráti 0 pri úspechu, body ukazuje za hlavičku.
+int parse_frame_delta_header(const char *datagram, unsigned int *tick, unsigned int *base,
+                             unsigned int *ack, FrameTiming *timing, int *width, int *height, const char **body);
+
+// Aplikuje telo rozdielu na keyframe a výsledný rámec zapíše do out. Vráti dĺžku alebo -1.
+int apply_frame_delta(char *out, size_t cap, const char *keyframe, int width, int height, const char *body);
+
+#endif // PROTOCOL_H
@@ -0,0 +1,137 @@
+#include "shm_channel.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t shm_channel_size(size_t frame_capacity) {
+    return sizeof(ShmChannel) + frame_capacity;
+}
+
+ShmChannel *shm_channel_create(const char *name, size_t frame_capacity) {
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return NULL;
+
+    size_t size = shm_channel_size(frame_capacity);
+    if (ftruncate(fd, (off_t)size) < 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    ShmChannel *channel = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (channel == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // ftruncate vynuluje obsah, stačí doplniť hlavičku
+    channel->frame_capacity = (uint32_t)frame_capacity;
+    atomic_init(&channel->frame_seq, 0);
+    atomic_init(&channel->input_head, 0);
+    atomic_init(&channel->input_tail, 0);
+    channel->magic = SHM_CHANNEL_MAGIC;
+    return channel;
+}
+
+ShmChannel *shm_channel_open(const char *name, size_t *frame_capacity) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(ShmChannel)) {
+        close(fd);
+        return NULL;
+    }
+    ShmChannel *channel = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (channel == MAP_FAILED) return NULL;
+
+    if (channel->magic != SHM_CHANNEL_MAGIC
+        || shm_channel_size(channel->frame_capacity) > (size_t)st.st_size) {
+        munmap(channel, (size_t)st.st_size);
+        return NULL;
+    }
+    *frame_capacity = channel->frame_capacity;
+    return channel;
+}
+
+void shm_channel_close(ShmChannel *channel, size_t frame_capacity, const char *name) {
+    if (channel) {
+        munmap(channel, shm_channel_size(frame_capacity));
+    }
+    if (name) {
+        shm_unlink(name);
+    }
+}
+
+void shm_channel_publish(ShmChannel *channel, size_t frame_capacity, unsigned int tick, unsigned int ack,
+                         const FrameTiming *timing, const char *frame, int length) {
+    if (length < 0) length = 0;
+    if ((size_t)length > frame_capacity) length = (int)frame_capacity;
+
+    unsigned int seq = atomic_load_explicit(&channel->frame_seq, memory_order_relaxed);
+    atomic_store_explicit(&channel->frame_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    channel->tick = tick;
+    channel->ack = ack;
+    channel->input_time_us = timing->input_time_us;
+    channel->input_wait_us = timing->input_wait_us;
+    channel->build_us = timing->build_us;
+    channel->length = (uint32_t)length;
+    memcpy(channel->frame, frame, (size_t)length);
+
+    atomic_store_explicit(&channel->frame_seq, seq + 2, memory_order_release);
+}
+
+int shm_channel_read(ShmChannel *channel, unsigned int last_tick, unsigned int *tick,
+                     unsigned int *ack, FrameTiming *timing, char *out, size_t cap) {
+    unsigned int before = atomic_load_explicit(&channel->frame_seq, memory_order_acquire);
+    if (before & 1) return -1;
+
+    unsigned int frame_tick = channel->tick;
+    if (before == 0 || frame_tick <= last_tick) return 0;
+    unsigned int frame_ack = channel->ack;
+    FrameTiming frame_timing = {channel->input_time_us, channel->input_wait_us, channel->build_us};
+    size_t length = channel->length;
+    if (length > channel->frame_capacity || length > cap) return -1;
+    memcpy(out, channel->frame, length);
+
+    // Ak server medzitým zapisoval, kópia môže byť zmiešaná a zahodí sa
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&channel->frame_seq, memory_order_relaxed) != before) return -1;
+
+    *tick = frame_tick;
+    *ack = frame_ack;
+    *timing = frame_timing;
+    return (int)length;
+}
+
+int shm_channel_push_input(ShmChannel *channel, unsigned int seq, int direction, uint64_t sent_us) {
+    unsigned int head = atomic_load_explicit(&channel->input_head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&channel->input_tail, memory_order_acquire);
+    if (head - tail >= SHM_INPUT_QUEUE_SIZE) return -1;
+
+    ShmInput *input = &channel->inputs[head & (SHM_INPUT_QUEUE_SIZE - 1)];
+    input->seq = seq;
+    input->direction = direction;
+    input->sent_us = sent_us;
+    atomic_store_explicit(&channel->input_head, head + 1, memory_order_release);
+    return 0;
+}
+
+int shm_channel_pop_input(ShmChannel *channel, unsigned int *seq, int *direction, uint64_t *sent_us) {
+    unsigned int tail = atomic_load_explicit(&channel->input_tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&channel->input_head, memory_order_acquire);
+    if (tail == head) return 0;
+
+    const ShmInput *input = &channel->inputs[tail & (SHM_INPUT_QUEUE_SIZE - 1)];
+    *seq = input->seq;
+    *direction = input->direction;
+    *sent_us = input->sent_us;
+    atomic_store_explicit(&channel->input_tail, tail + 1, memory_order_release);
+    return 1;
+}
@@ -0,0 +1,66 @@
+#ifndef SHM_CHANNEL_H
+#define SHM_CHANNEL_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "protocol.h"
+
+// Lokálny prenos cez zdieľanú pamäť (vyjednaný riadkom "transport shm" cez TCP):
+// server zapisuje posledný rámec do slotu chráneného seqlockom a klient z neho číta
+// priamo, vstupy posiela klient cez malú kruhovú frontu. TCP ostáva len na nastavenie,
+// riadiace príkazy a koniec hry. Zápis aj čítanie rámca sú bez systémových volaní.
+
+#define SHM_CHANNEL_MAGIC 0x4d485353u   // "SSHM"
+#define SHM_INPUT_QUEUE_SIZE 64         // Kapacita fronty vstupov (mocnina dvoch)
+#define SHM_POLL_INTERVAL_MS 5          // Ako často klient kontroluje nový rámec
+
+typedef struct {
+    uint32_t seq;
+    int32_t direction;
+    uint64_t sent_us;              // Čas klienta pri odoslaní (viď FrameTiming)
+} ShmInput;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t frame_capacity;       // Veľkosť poľa frame
+    atomic_uint frame_seq;         // Seqlock: nepárna hodnota = server práve zapisuje
+    uint32_t tick;                 // Hlavička posledného rámca (chránená seqlockom)
+    uint32_t ack;
+    uint32_t length;
+    uint64_t input_time_us;        // FrameTiming posledného rámca (chránené seqlockom)
+    uint32_t input_wait_us;
+    uint32_t build_us;
+    atomic_uint input_head;        // Zapisuje len klient
+    atomic_uint input_tail;        // Zapisuje len server
+    ShmInput inputs[SHM_INPUT_QUEUE_SIZE];
+    char frame[];                  // Posledný rámec (mapa + súhrn)
+} ShmChannel;
+
+// Vytvorí a namapuje nový kanál s daným menom. Vráti NULL pri chybe. Volajúci si frame_capacity
+// uchová sám: pole v zdieľanej pamäti môže druhá strana prepísať.
+ShmChannel *shm_channel_create(const char *name, size_t frame_capacity);
+
+// Namapuje existujúci kanál, ktorý vytvoril server, a do frame_capacity zapíše jeho kapacitu
+// overenú voči veľkosti mapovania. Vráti NULL pri chybe.
+ShmChannel *shm_channel_open(const char *name, size_t *frame_capacity);
+
+// Odmapuje kanál s kapacitou z create/open; ak je name nenulové, aj ho odstráni zo systému.
+void shm_channel_close(ShmChannel *channel, size_t frame_capacity, const char *name);
+
+// Zverejní nový rámec (zapisuje len server). Rámec dlhší ako frame_capacity sa oreže.
+void shm_channel_publish(ShmChannel *channel, size_t frame_capacity, unsigned int tick, unsigned int ack,
+                         const FrameTiming *timing, const char *frame, int length);
+
+// Skopíruje posledný rámec, ak je novší ako last_tick. Vráti dĺžku rámca, 0 ak nový rámec
+// nie je, -1 ak sa nepodarilo získať konzistentnú kópiu (server práve zapisoval).
+int shm_channel_read(ShmChannel *channel, unsigned int last_tick, unsigned int *tick,
+                     unsigned int *ack, FrameTiming *timing, char *out, size_t cap);
+
+// Zaradí vstup do fronty (volá len klient). Vráti -1, ak je fronta plná.
+int shm_channel_push_input(ShmChannel *channel, unsigned int seq, int direction, uint64_t sent_us);
+
+// Vyberie najstarší vstup z fronty (volá len server). Vráti 1, ak nejaký bol.
+int shm_channel_pop_input(ShmChannel *channel, unsigned int *seq, int *direction, uint64_t *sent_us);
+
+#endif // SHM_CHANNEL_H
@@ -0,0 +1,91 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "protocol.h"
+#include "verify_protocol.h"
+
+// Prečíta zo socketu ďalšiu správu. Vráti 1, 0 pri konci spojenia alebo -1 pri chybe.
+static int read_message(StreamReader *reader, int fd, Message *message) {
+    int result;
+    while ((result = stream_reader_next_message(reader, message)) == 0) {
+        if (stream_reader_fill(reader, fd) <= 0) return 0;
+    }
+    return result;
+}
+
+// Pošle cez socketpair veľký rámec a za ním krátku správu a prečíta ich cez reader.
+static const char *check_large_frame(StreamReader *reader) {
+    int fds[2];
+    char *payload = malloc(VERIFY_PROTOCOL_PAYLOAD);
+    if (!payload || socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        free(payload);
+        return "socketpair";
+    }
+    for (int i = 0; i < VERIFY_PROTOCOL_PAYLOAD; i++) {
+        payload[i] = (char)('a' + i % 26);
+    }
+
+    const char *difference = NULL;
+    Message message;
+    if (send_message(fds[0], MSG_FRAME, 7, 3, payload, VERIFY_PROTOCOL_PAYLOAD) < 0
+        || send_message(fds[0], MSG_STATUS, 0, 0, "ok", 2) < 0) {
+        difference = "send";
+    } else if (read_message(reader, fds[1], &message) != 1) {
+        difference = "veľký rámec sa neprečítal";
+    } else if (message.type != MSG_FRAME || message.tick != 7 || message.length != VERIFY_PROTOCOL_PAYLOAD
+               || memcmp(message.payload, payload, VERIFY_PROTOCOL_PAYLOAD) != 0) {
+        difference = "obsah veľkého rámca";
+    } else if (read_message(reader, fds[1], &message) != 1) {
+        difference = "správa za veľkým rámcom sa neprečítala";
+    } else if (message.type != MSG_STATUS || message.length != 2 || memcmp(message.payload, "ok", 2) != 0) {
+        difference = "obsah správy za veľkým rámcom";
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    free(payload);
+    return difference;
+}
+
+// Riadok dlhší ako max_size musí čítanie ukončiť chybou EMSGSIZE, nie zväčšením buffera.
+static const char *check_line_limit(void) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return "socketpair";
+
+    char chunk[256];
+    memset(chunk, 'x', sizeof(chunk));
+    StreamReader reader;
+    const char *difference = stream_reader_init(&reader) < 0 ? "malloc" : NULL;
+    reader.max_size = VERIFY_PROTOCOL_MAX_SIZE;
+    for (size_t sent = 0; !difference && sent < 2 * VERIFY_PROTOCOL_MAX_SIZE; sent += sizeof(chunk)) {
+        if (write(fds[0], chunk, sizeof(chunk)) != (ssize_t)sizeof(chunk)) difference = "write";
+    }
+
+    int result = 1;
+    while (!difference && result > 0 && stream_reader_next_line(&reader) == NULL) {
+        result = stream_reader_fill(&reader, fds[1]);
+    }
+    if (!difference && (result >= 0 || errno != EMSGSIZE)) {
+        difference = "riadok nad max_size sa neodmietol";
+    } else if (!difference && reader.size >= VERIFY_PROTOCOL_MAX_SIZE) {
+        difference = "čítač prijal viac ako max_size";
+    }
+
+    stream_reader_free(&reader);
+    close(fds[0]);
+    close(fds[1]);
+    return difference;
+}
+
+const char *verify_protocol(void) {
+    StreamReader reader;
+    StreamReader empty = {0};
+    const char *difference = stream_reader_init(&reader) < 0 ? "malloc" : check_large_frame(&reader);
+    if (!difference) difference = check_large_frame(&empty);
+    if (!difference) difference = check_line_limit();
+    stream_reader_free(&reader);
+    stream_reader_free(&empty);
+    return difference;
+}
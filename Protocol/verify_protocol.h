@@ -0,0 +1,15 @@
+#ifndef VERIFY_PROTOCOL_H
+#define VERIFY_PROTOCOL_H
+
+// Samokontrola rámcovania správ (server --verify-protocol): cez socketpair sa pošle rámec
+// väčší ako počiatočný buffer StreamReader a za ním krátka správa; čítač ich musí vybrať
+// celé, aj keď začína prázdny (ako po neúspešnom init). Čítač s max_size musí riadok
+// nad limitom odmietnuť s EMSGSIZE namiesto zväčšovania buffera.
+
+#define VERIFY_PROTOCOL_PAYLOAD (4 * STREAM_READER_INITIAL_CAPACITY + 123) // Veľký rámec pre čítač
+#define VERIFY_PROTOCOL_MAX_SIZE 1024 // Limit čítača pri kontrole príliš dlhého riadku
+
+// Spustí kontroly. Vráti NULL, ak všetky prešli, inak popis prvej chyby.
+const char *verify_protocol(void);
+
+#endif // VERIFY_PROTOCOL_H
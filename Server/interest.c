@@ -0,0 +1,32 @@
+#include "interest.h"
+
+void interest_reset(InterestArea *area) {
+    area->origin_x = 0;
+    area->origin_y = 0;
+    area->width = 0;
+    area->height = 0;
+}
+
+// Začiatok oblasti na jednej osi. Ostane na mieste, kým je hlava aspoň margin políčok
+// od okraja oblasti; inak sa hlava dostane do stredu. Oblasť nikdy nepresahuje svet.
+static int follow_axis(int origin, int head, int view, int size, int recentre) {
+    int margin = view / INTEREST_MARGIN_DIVISOR;
+    if (recentre || head < origin + margin || head >= origin + view - margin) {
+        origin = head - view / 2;
+    }
+    if (origin > size - view) origin = size - view;
+    return origin < 0 ? 0 : origin;
+}
+
+int interest_follow(InterestArea *area, Point head, int width, int height, int world_width, int world_height) {
+    int resized = area->width != width || area->height != height;
+    int origin_x = follow_axis(area->origin_x, head.x, width, world_width, resized);
+    int origin_y = follow_axis(area->origin_y, head.y, height, world_height, resized);
+    int moved = resized || origin_x != area->origin_x || origin_y != area->origin_y;
+
+    area->origin_x = origin_x;
+    area->origin_y = origin_y;
+    area->width = width;
+    area->height = height;
+    return moved;
+}
@@ -0,0 +1,33 @@
+#ifndef INTEREST_H
+#define INTEREST_H
+
+#include "../Game_logic/game_logic.h"
+
+// Oblasť záujmu spojenia: obdĺžnik sveta, ktorý klient vidí a z ktorého dostáva zmeny.
+// Oblasť sleduje hlavu s hysteréziou - kým je hlava vo vnútornej časti oblasti, oblasť
+// stojí a rozdiely rámcov nesú len skutočné zmeny. Až keď sa hlava priblíži k okraju,
+// oblasť sa znova vycentruje (jeden väčší rámec namiesto posunu celého výrezu každý ťah).
+
+#define INTEREST_MARGIN_DIVISOR 4 // Okraj oblasti, kde sa oblasť posúva (zlomok jej rozmeru)
+
+typedef struct {
+    int origin_x;  // Ľavý horný roh oblasti vo svete
+    int origin_y;
+    int width;     // 0 = oblasť ešte nie je určená
+    int height;
+} InterestArea;
+
+// Zabudne polohu oblasti (nová hra, nový klient); najbližšie interest_follow ju vycentruje.
+void interest_reset(InterestArea *area);
+
+// Prispôsobí oblasť rozmeru width x height a polohe hlavy vo svete world_width x world_height.
+// Vráti 1, ak sa oblasť posunula alebo zmenila rozmer, inak 0.
+int interest_follow(InterestArea *area, Point head, int width, int height, int world_width, int world_height);
+
+// Zistí, či políčko (x, y) leží v oblasti.
+static inline int interest_contains(const InterestArea *area, int x, int y) {
+    return x >= area->origin_x && x < area->origin_x + area->width
+        && y >= area->origin_y && y < area->origin_y + area->height;
+}
+
+#endif // INTEREST_H
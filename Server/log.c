@@ -0,0 +1,238 @@
+#include "log.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+typedef struct {
+    LogLevel level;
+    long long timestamp_ms; // CLOCK_REALTIME v milisekundách
+    char text[LOG_LINE_MAX];
+} LogRecord;
+
+// Buffer jedného vlákna: zapisuje len vlastník (head), číta len zapisovacie vlákno (tail).
+typedef struct LogRing {
+    LogRecord records[LOG_RING_SIZE];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_uint dropped;       // Správy zahodené pre plný buffer
+    atomic_int in_use;
+    // Stav potláčania opakovaných správ (používa len zapisovacie vlákno)
+    char last_text[LOG_LINE_MAX];
+    unsigned int repeat_count;
+    long long repeat_since_ms;
+    struct LogRing *next;
+} LogRing;
+
+static LogRing *log_rings = NULL;
+static pthread_mutex_t log_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t log_key;
+static pthread_once_t log_key_once = PTHREAD_ONCE_INIT;
+static pthread_t log_writer;
+static atomic_int log_running = 0;
+static LogLevel log_min_level = LOG_LEVEL_INFO;
+static char log_tag[16] = ""; // Označenie procesu (worker) pred každou správou
+
+static _Thread_local LogRing *log_local_ring = NULL;
+
+static const char *log_level_names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+static long long realtime_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void log_release_ring(void *ring) {
+    atomic_store(&((LogRing *)ring)->in_use, 0);
+}
+
+static void log_create_key(void) {
+    pthread_key_create(&log_key, log_release_ring);
+}
+
+static LogRing *log_acquire_ring(void) {
+    pthread_once(&log_key_once, log_create_key);
+
+    pthread_mutex_lock(&log_rings_mutex);
+    LogRing *ring = log_rings;
+    while (ring) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&ring->in_use, &expected, 1)) {
+            break;
+        }
+        ring = ring->next;
+    }
+    if (!ring) {
+        ring = calloc(1, sizeof(LogRing));
+        if (ring) {
+            atomic_init(&ring->in_use, 1);
+            ring->next = log_rings;
+            log_rings = ring;
+        }
+    }
+    pthread_mutex_unlock(&log_rings_mutex);
+
+    if (ring) {
+        pthread_setspecific(log_key, ring);
+    }
+    return ring;
+}
+
+void log_message(LogLevel level, const char *format, ...) {
+    if (level < log_min_level) return;
+
+    LogRing *ring = log_local_ring;
+    if (!ring) {
+        ring = log_local_ring = log_acquire_ring();
+        if (!ring) return;
+    }
+
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= LOG_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    LogRecord *record = &ring->records[head & (LOG_RING_SIZE - 1)];
+    record->level = level;
+    record->timestamp_ms = realtime_ms();
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record->text, sizeof(record->text), format, args);
+    va_end(args);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static void log_write_line(FILE *out, LogLevel level, long long timestamp_ms, const char *text) {
+    time_t seconds = (time_t)(timestamp_ms / 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    fprintf(out, "[%02d:%02d:%02d.%03d] %-5s %s%s%s",
+            local.tm_hour, local.tm_min, local.tm_sec, (int)(timestamp_ms % 1000),
+            log_level_names[level], log_tag, log_tag[0] ? " " : "", text);
+    size_t length = strlen(text);
+    if (length == 0 || text[length - 1] != '\n') {
+        fputc('\n', out);
+    }
+}
+
+static void log_flush_repeats(FILE *out, LogRing *ring, long long now_ms) {
+    if (ring->repeat_count == 0) return;
+    char note[64];
+    snprintf(note, sizeof(note), "(predchádzajúca správa sa zopakovala %u-krát)", ring->repeat_count);
+    log_write_line(out, LOG_LEVEL_INFO, now_ms, note);
+    ring->repeat_count = 0;
+}
+
+// Vyprázdni všetky buffery. Opakované rovnaké správy sa zlúčia do jedného súhrnu za sekundu.
+static void log_drain(FILE *out) {
+    long long now_ms = realtime_ms();
+
+    pthread_mutex_lock(&log_rings_mutex);
+    for (LogRing *ring = log_rings; ring; ring = ring->next) {
+        unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            const LogRecord *record = &ring->records[tail & (LOG_RING_SIZE - 1)];
+            if (strcmp(record->text, ring->last_text) == 0) {
+                if (ring->repeat_count++ == 0) {
+                    ring->repeat_since_ms = record->timestamp_ms;
+                }
+                continue;
+            }
+            log_flush_repeats(out, ring, record->timestamp_ms);
+            log_write_line(out, record->level, record->timestamp_ms, record->text);
+            memcpy(ring->last_text, record->text, sizeof(ring->last_text));
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        if (ring->repeat_count > 0 && now_ms - ring->repeat_since_ms >= 1000) {
+            log_flush_repeats(out, ring, now_ms);
+        }
+
+        unsigned int dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+        if (dropped > 0) {
+            char note[64];
+            snprintf(note, sizeof(note), "(zahodených %u správ, buffer vlákna bol plný)", dropped);
+            log_write_line(out, LOG_LEVEL_WARN, now_ms, note);
+        }
+    }
+    pthread_mutex_unlock(&log_rings_mutex);
+
+    fflush(out);
+}
+
+static void *log_writer_thread(void *arg) {
+    (void)arg;
+    struct timespec interval = {0, LOG_FLUSH_INTERVAL_MS * 1000000L};
+    while (atomic_load(&log_running)) {
+        log_drain(stdout);
+        nanosleep(&interval, NULL);
+    }
+    log_drain(stdout);
+    return NULL;
+}
+
+// Fork počká, kým zapisovacie vlákno dokončí výpis, aby potomok nezdedil zamknutý
+// log_rings_mutex ani zámok stdout od vlákna, ktoré v ňom už neexistuje. fflush v log_drain
+// beží mimo log_rings_mutex, preto sa zámok stdout berie zvlášť (v rovnakom poradí ako log_drain).
+static void log_prepare_fork(void) {
+    pthread_mutex_lock(&log_rings_mutex);
+    flockfile(stdout);
+}
+
+static void log_finish_fork(void) {
+    funlockfile(stdout);
+    pthread_mutex_unlock(&log_rings_mutex);
+}
+
+int log_init(LogLevel default_level) {
+    log_min_level = default_level;
+    const char *level = getenv("SNAKE_LOG_LEVEL");
+    if (level) {
+        for (int i = LOG_LEVEL_DEBUG; i <= LOG_LEVEL_ERROR; i++) {
+            if (strcasecmp(level, log_level_names[i]) == 0) {
+                log_min_level = (LogLevel)i;
+            }
+        }
+    }
+
+    pthread_atfork(log_prepare_fork, log_finish_fork, log_finish_fork);
+
+    atomic_store(&log_running, 1);
+    if (pthread_create(&log_writer, NULL, log_writer_thread, NULL) != 0) {
+        atomic_store(&log_running, 0);
+        return -1;
+    }
+    return 0;
+}
+
+void log_shutdown(void) {
+    if (!atomic_exchange(&log_running, 0)) return;
+    pthread_join(log_writer, NULL);
+}
+
+void log_after_fork(const char *tag) {
+    snprintf(log_tag, sizeof(log_tag), "[%s]", tag);
+
+    for (LogRing *ring = log_rings; ring; ring = ring->next) {
+        // Nevypísané správy rodiča vypíše rodič, buffery ostatných vlákien sú voľné
+        atomic_store(&ring->tail, atomic_load(&ring->head));
+        ring->repeat_count = 0;
+        if (ring != log_local_ring) {
+            atomic_store(&ring->in_use, 0);
+        }
+    }
+
+    if (atomic_load(&log_running)
+        && pthread_create(&log_writer, NULL, log_writer_thread, NULL) != 0) {
+        atomic_store(&log_running, 0);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Asynchrónne logovanie: vlákna zapisujú do vlastných kruhových bufferov bez zámkov
+// a na terminál ich vypisuje samostatné vlákno, takže herné vlákna nikdy nečakajú na stdout.
+
+#define LOG_RING_SIZE 256          // Počet správ v bufferi jedného vlákna (mocnina dvoch)
+#define LOG_LINE_MAX 256           // Maximálna dĺžka jednej správy
+#define LOG_FLUSH_INTERVAL_MS 20   // Ako často zapisovacie vlákno vyprázdňuje buffery
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+} LogLevel;
+
+// Spustí zapisovacie vlákno. Minimálnu úroveň možno zmeniť premennou SNAKE_LOG_LEVEL
+// (debug, info, warn, error). Vráti 0 pri úspechu.
+int log_init(LogLevel default_level);
+
+// Vypíše všetky zostávajúce správy a ukončí zapisovacie vlákno.
+void log_shutdown(void);
+
+// Znova spustí zapisovacie vlákno v potomkovi po fork(). Správy sa označia daným tagom.
+void log_after_fork(const char *tag);
+
+// Zaradí správu do buffera volajúceho vlákna. Ak je buffer plný, správa sa zahodí (a započíta).
+void log_message(LogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#define LOG_DEBUG(...) log_message(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) log_message(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...) log_message(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) log_message(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif // LOG_H
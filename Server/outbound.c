@@ -0,0 +1,200 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "log.h"
+#include "outbound.h"
+#include "scheduler.h"
+#include "supervisor.h"
+
+void outbound_init(OutboundQueue *queue) {
+    memset(queue, 0, sizeof(*queue));
+    queue->fd = -1;
+    queue->wake_fd = -1;
+}
+
+int outbound_attach(OutboundQueue *queue, int fd) {
+    outbound_detach(queue);
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        LOG_ERROR("fcntl O_NONBLOCK failed: %s", strerror(errno));
+        return -1;
+    }
+    queue->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->wake_fd < 0) {
+        LOG_ERROR("eventfd failed: %s", strerror(errno));
+        return -1;
+    }
+    queue->fd = fd;
+    return 0;
+}
+
+void outbound_detach(OutboundQueue *queue) {
+    if (queue->wake_fd >= 0) {
+        close(queue->wake_fd);
+    }
+    free(queue->data);
+    free(queue->frame);
+    outbound_init(queue);
+}
+
+// Klient nestíha alebo spojenie zlyhalo: socket sa zavrie pre obe strany, vlákno klienta
+// to uvidí ako odpojenie a miestnosť počká na návrat hráča. Chybu zápisu odpojenému
+// klientovi zistí aj čítanie, takže stačí úroveň LOG_LEVEL_DEBUG.
+static int outbound_fail(OutboundQueue *queue, LogLevel level, const char *reason) {
+    if (!queue->failed) {
+        queue->failed = 1;
+        log_message(level, "Spojenie %d: %s, neodoslaných %zu bajtov, odpája sa.",
+                    queue->fd, reason, queue->size - queue->sent + queue->frame_length);
+        shutdown(queue->fd, SHUT_RDWR);
+    }
+    return -1;
+}
+
+// Zväčší buffer (zdvojnásobením) aspoň na needed bajtov.
+static int reserve(char **buffer, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) return 0;
+    size_t grown_capacity = *capacity ? *capacity : OUTBOUND_INITIAL_CAPACITY;
+    while (grown_capacity < needed) grown_capacity *= 2;
+    char *grown = realloc(*buffer, grown_capacity);
+    if (!grown) return -1;
+    *buffer = grown;
+    *capacity = grown_capacity;
+    return 0;
+}
+
+static int append(OutboundQueue *queue, const char *bytes, size_t length) {
+    if (queue->sent > 0) {
+        memmove(queue->data, queue->data + queue->sent, queue->size - queue->sent);
+        queue->size -= queue->sent;
+        queue->sent = 0;
+    }
+    if (reserve(&queue->data, &queue->capacity, queue->size + length) < 0) return -1;
+    memcpy(queue->data + queue->size, bytes, length);
+    queue->size += length;
+    return 0;
+}
+
+// Zobudí vlákno klienta: pri neodoslaných bajtoch počká na zapisovateľný socket, po riadiacej
+// správe (napr. koniec hry) si hneď overí stav miestnosti.
+static void wake_writer(OutboundQueue *queue, int always) {
+    if (always || outbound_pending(queue)) {
+        uint64_t one = 1;
+        ssize_t ignored = write(queue->wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+int outbound_message(OutboundQueue *queue, MessageType type, unsigned int tick, unsigned int ack,
+                     const char *payload, int length) {
+    return outbound_message_timed(queue, type, tick, ack, NULL, 0, payload, length);
+}
+
+int outbound_message_timed(OutboundQueue *queue, MessageType type, unsigned int tick, unsigned int ack,
+                           const FrameTiming *timing, unsigned long long hash, const char *payload, int length) {
+    if (queue->fd < 0 || queue->failed) return -1;
+
+    // Čakajúci rámec patrí pred túto správu (napr. posledná mapa pred koncom hry)
+    if (queue->frame_length > 0) {
+        if (append(queue, queue->frame, queue->frame_length) < 0) {
+            return outbound_fail(queue, LOG_LEVEL_ERROR, "málo pamäte");
+        }
+        queue->frame_length = 0;
+    }
+    char header[MESSAGE_HEADER_MAX];
+    int header_length = format_message_header(header, sizeof(header), type, tick, ack, timing, hash, length);
+    if (append(queue, header, (size_t)header_length) < 0 || append(queue, payload, (size_t)length) < 0) {
+        return outbound_fail(queue, LOG_LEVEL_ERROR, "málo pamäte");
+    }
+    if (queue->size - queue->sent > OUTBOUND_MAX_BYTES) {
+        METRIC_ADD(slow_disconnects, 1);
+        return outbound_fail(queue, LOG_LEVEL_WARN, "klient neprijíma správy");
+    }
+
+    int result = outbound_flush(queue);
+    wake_writer(queue, 1);
+    return result;
+}
+
+int outbound_frame(OutboundQueue *queue, unsigned int tick, unsigned int ack, const FrameTiming *timing,
+                   unsigned long long hash, const char *frame, int length) {
+    if (queue->fd < 0 || queue->failed) return -1;
+
+    // Klient, ktorý ešte nedostal predchádzajúci rámec, dostane rovno tento
+    if (queue->frame_length > 0) {
+        METRIC_ADD(frames_replaced, 1);
+    }
+    char header[MESSAGE_HEADER_MAX];
+    int header_length = format_message_header(header, sizeof(header), MSG_FRAME, tick, ack, timing, hash, length);
+    size_t total = (size_t)header_length + (size_t)length;
+    if (reserve(&queue->frame, &queue->frame_capacity, total) < 0) {
+        return outbound_fail(queue, LOG_LEVEL_ERROR, "málo pamäte");
+    }
+    memcpy(queue->frame, header, (size_t)header_length);
+    memcpy(queue->frame + header_length, frame, (size_t)length);
+    queue->frame_length = total;
+
+    int result = outbound_flush(queue);
+    wake_writer(queue, 0);
+    return result;
+}
+
+int outbound_flush(OutboundQueue *queue) {
+    if (queue->fd < 0 || queue->failed) return -1;
+
+    int progress = 0;
+    while (1) {
+        if (queue->sent == queue->size) {
+            queue->sent = queue->size = 0;
+            if (queue->frame_length == 0) break;
+            // Rámec sa začne posielať: buffery sa vymenia, nič sa nekopíruje
+            char *data = queue->data;
+            size_t capacity = queue->capacity;
+            queue->data = queue->frame;
+            queue->capacity = queue->frame_capacity;
+            queue->size = queue->frame_length;
+            queue->frame = data;
+            queue->frame_capacity = capacity;
+            queue->frame_length = 0;
+        }
+
+        ssize_t written = send(queue->fd, queue->data + queue->sent, queue->size - queue->sent,
+                               MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written > 0) {
+            queue->sent += (size_t)written;
+            progress = 1;
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return outbound_fail(queue, LOG_LEVEL_DEBUG, strerror(errno));
+        }
+    }
+
+    // Pomalý klient sa pozná podľa toho, že jeho socket dlho neprijal ani bajt
+    int64_t now_ms = scheduler_now_ms();
+    if (!outbound_pending(queue)) {
+        queue->stalled_since_ms = 0;
+    } else if (progress || queue->stalled_since_ms == 0) {
+        queue->stalled_since_ms = now_ms;
+    } else if (now_ms - queue->stalled_since_ms > OUTBOUND_STALL_MS) {
+        METRIC_ADD(slow_disconnects, 1);
+        return outbound_fail(queue, LOG_LEVEL_WARN, "klient dlho neprijíma dáta");
+    }
+    return 0;
+}
+
+void outbound_drain(OutboundQueue *queue) {
+    int64_t deadline_ms = scheduler_now_ms() + OUTBOUND_DRAIN_MS;
+    while (outbound_pending(queue) && outbound_flush(queue) == 0 && outbound_pending(queue)) {
+        int64_t remaining_ms = deadline_ms - scheduler_now_ms();
+        if (remaining_ms <= 0) break;
+        struct pollfd writable = {queue->fd, POLLOUT, 0};
+        if (poll(&writable, 1, (int)remaining_ms) < 0 && errno != EINTR) break;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef OUTBOUND_H
+#define OUTBOUND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../Protocol/protocol.h"
+
+// Odchádzajúci front jedného TCP spojenia. Socket je neblokujúci: správy sa zapíšu, koľko
+// sa zmestí do jeho buffera, a zvyšok dopíše vlákno klienta, keď je socket znova zapisovateľný.
+// Riadiace správy (token, prenos, koniec) idú v poradí; rámec, ktorý sa ešte nezačal posielať,
+// nahradí novší rámec. Klient, ktorý dlho nič neprijme, sa odpojí (ako pri výpadku spojenia).
+
+#define OUTBOUND_INITIAL_CAPACITY 4096
+#define OUTBOUND_MAX_BYTES (256 * 1024) // Najviac neodoslaných riadiacich bajtov
+#define OUTBOUND_STALL_MS 10000         // Ako dlho môže front čakať bez jediného odoslaného bajtu
+#define OUTBOUND_DRAIN_MS 1000          // Ako dlho sa pred zatvorením spojenia dopisuje front
+
+typedef struct {
+    int fd;                   // Socket klienta, -1 bez spojenia
+    int wake_fd;              // eventfd: zobudí vlákno klienta, aby čakalo aj na zápis
+    char *data;               // Správy v poradí; neodoslané sú bajty od sent po size
+    size_t sent;
+    size_t size;
+    size_t capacity;
+    char *frame;              // Posledný rámec (hlavička + mapa), ktorý sa ešte nezačal posielať
+    size_t frame_length;
+    size_t frame_capacity;
+    int64_t stalled_since_ms; // Odkedy front čaká bez pokroku, 0 = nečaká
+    int failed;               // Spojenie sa kvôli chybe alebo pomalému klientovi ukončuje
+} OutboundQueue;
+
+// Pripraví prázdny front bez spojenia. Volá sa raz pre každý slot miestnosti.
+void outbound_init(OutboundQueue *queue);
+
+// Prepne socket do neblokujúceho režimu a pripojí k nemu prázdny front. Vráti 0 pri úspechu.
+int outbound_attach(OutboundQueue *queue, int fd);
+
+// Zahodí neodoslané správy a odpojí front od socketu (socket nezatvára).
+void outbound_detach(OutboundQueue *queue);
+
+// Zaradí riadiacu správu za všetky predchádzajúce a skúsi ju odoslať. Vráti -1, ak spojenie zlyhalo.
+int outbound_message(OutboundQueue *queue, MessageType type, unsigned int tick, unsigned int ack,
+                     const char *payload, int length);
+
+// Ako outbound_message, hlavička nesie aj časy ťahu (STEP) a hash stavu (STATE, STEP).
+int outbound_message_timed(OutboundQueue *queue, MessageType type, unsigned int tick, unsigned int ack,
+                           const FrameTiming *timing, unsigned long long hash, const char *payload, int length);
+
+// Zaradí rámec; ešte neodoslaný starší rámec sa zahodí. Vráti -1, ak spojenie zlyhalo.
+int outbound_frame(OutboundQueue *queue, unsigned int tick, unsigned int ack, const FrameTiming *timing,
+                   unsigned long long hash, const char *frame, int length);
+
+// Zapíše do socketu, koľko sa dá bez čakania. Vráti -1, ak spojenie zlyhalo.
+int outbound_flush(OutboundQueue *queue);
+
+// Zistí, či vo fronte ostali neodoslané bajty (vlákno klienta potom čaká aj na POLLOUT).
+static inline int outbound_pending(const OutboundQueue *queue) {
+    return !queue->failed && (queue->sent < queue->size || queue->frame_length > 0);
+}
+
+// Pred zatvorením spojenia počká najviac OUTBOUND_DRAIN_MS, kým sa front odošle.
+void outbound_drain(OutboundQueue *queue);
+
+#endif // OUTBOUND_H
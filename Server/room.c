@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "../Game_logic/game_snapshot.h"
+#include "log.h"
+#include "room.h"
+#include "scheduler.h"
+#include "supervisor.h"
+
+static Room rooms[MAX_ROOMS];
+static pthread_mutex_t rooms_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char room_snapshot_dir[200];
+
+// Vygeneruje náhodný hexadecimálny token z /dev/urandom.
+static int generate_token(char *token) {
+    unsigned char random_bytes[RESUME_TOKEN_LENGTH / 2];
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("open /dev/urandom failed: %s", strerror(errno));
+        return -1;
+    }
+    ssize_t got = read(fd, random_bytes, sizeof(random_bytes));
+    close(fd);
+    if (got != (ssize_t)sizeof(random_bytes)) {
+        return -1;
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < sizeof(random_bytes); i++) {
+        token[2 * i] = hex[random_bytes[i] >> 4];
+        token[2 * i + 1] = hex[random_bytes[i] & 0x0f];
+    }
+    token[RESUME_TOKEN_LENGTH] = '\0';
+
+    // Prvý bajt tokenu určuje workera, ktorý miestnosť vlastní (viď token_owner)
+    if (worker_index >= 0) {
+        token[0] = hex[(worker_index >> 4) & 0x0f];
+        token[1] = hex[worker_index & 0x0f];
+    }
+    return 0;
+}
+
+// Ochranná lehota vypršala a hráč sa nevrátil. Beží na plánovacom vlákne.
+static void room_grace_expired(void *context) {
+    Room *room = context;
+    int expired = 0;
+
+    pthread_mutex_lock(&rooms_mutex);
+    if (room->state == ROOM_PARKED) {
+        room->state = ROOM_CLOSING;
+        expired = 1;
+    }
+    pthread_mutex_unlock(&rooms_mutex);
+
+    if (expired) {
+        LOG_INFO("Miestnosť %d: hráč sa nevrátil, hra zrušená.", room->id);
+        room_destroy(room);
+    }
+}
+
+// Vezme z poolu arénu pre rozmer miestnosti a nasmeruje do nej hru aj buffery.
+static int room_attach_arena(Room *room) {
+    room->arena = room_arena_acquire(room->width, room->height);
+    if (!room->arena) {
+        LOG_ERROR("Miestnosť %d: aréna pre hru %dx%d sa nedá pripraviť.", room->id, room->width, room->height);
+        return -1;
+    }
+    room->game = room->arena->game;
+    room->frame_buffer = room->arena->frame_buffer;
+    room->keyframe = room->arena->keyframe;
+    return 0;
+}
+
+// Uvoľní hru a vráti arénu do poolu.
+static void room_detach_arena(Room *room) {
+    if (room->game) {
+        release_game(room->game);
+    }
+    room_arena_release(room->arena);
+    room->arena = NULL;
+    room->game = NULL;
+    room->frame_buffer = NULL;
+    room->keyframe = NULL;
+    room->keyframe_tick = 0; // Klient dostane nový keyframe
+}
+
+void rooms_init(const char *snapshot_dir) {
+    snprintf(room_snapshot_dir, sizeof(room_snapshot_dir), "%s", snapshot_dir);
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        rooms[i].id = i;
+        rooms[i].state = ROOM_FREE;
+        outbound_init(&rooms[i].outbound);
+    }
+    room_arenas_init();
+}
+
+Room *room_create(int client_socket, int width, int height) {
+    pthread_mutex_lock(&rooms_mutex);
+    Room *room = NULL;
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        if (rooms[i].state == ROOM_FREE) {
+            room = &rooms[i];
+            room->state = ROOM_ACTIVE;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&rooms_mutex);
+
+    if (!room) {
+        LOG_WARN("Žiadna voľná miestnosť.");
+        return NULL;
+    }
+
+    room->client_socket = client_socket;
+    room->suspended = 0;
+    room->tick = 0;
+    room->last_input_seq = 0;
+    room->last_input_time_us = 0;
+    room->timed_input_seq = 0;
+    room->input_wait_us = 0;
+    room->tick_start_us = 0;
+    room->use_udp = 0;
+    room->udp_addr_known = 0;
+    room->keyframe_requested = 0;
+    room->lockstep = 0;
+    room->shm = NULL;
+    room->keyframe_tick = 0;
+    room->width = width;
+    room->height = height;
+    room->terminal_columns = 0;
+    room->terminal_rows = 0;
+    interest_reset(&room->view);
+    timer_init(&room->grace_timer, room_grace_expired, room);
+    snprintf(room->snapshot_path, sizeof(room->snapshot_path), "%s/snake_room_%d_%d.snap",
+             room_snapshot_dir, (int)getpid(), room->id);
+    snprintf(room->sem_name, sizeof(room->sem_name), "/game_update_%d_%d", (int)getpid(), room->id);
+    snprintf(room->shm_name, sizeof(room->shm_name), "/snake_shm_%d_%d", (int)getpid(), room->id);
+
+    if (room_attach_arena(room) < 0) {
+        room->state = ROOM_FREE;
+        return NULL;
+    }
+
+    sem_unlink(room->sem_name);
+    room->sem_game_update = sem_open(room->sem_name, O_CREAT | O_EXCL, 0644, 1);
+    if (room->sem_game_update == SEM_FAILED) {
+        LOG_ERROR("sem_open failed: %s", strerror(errno));
+        room_detach_arena(room);
+        room->state = ROOM_FREE;
+        return NULL;
+    }
+
+    if (generate_token(room->token) < 0 || outbound_attach(&room->outbound, client_socket) < 0) {
+        LOG_ERROR("Nepodarilo sa pripraviť miestnosť.");
+        outbound_detach(&room->outbound);
+        sem_close(room->sem_game_update);
+        sem_unlink(room->sem_name);
+        room_detach_arena(room);
+        room->state = ROOM_FREE;
+        return NULL;
+    }
+
+    METRIC_ADD(active_rooms, 1);
+    return room;
+}
+
+Room *room_claim(const char *token, int client_socket) {
+    Room *room = NULL;
+    pthread_mutex_lock(&rooms_mutex);
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        if (rooms[i].state == ROOM_PARKED && strcmp(rooms[i].token, token) == 0) {
+            room = &rooms[i];
+            room->state = ROOM_ACTIVE;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&rooms_mutex);
+
+    if (room) {
+        scheduler_disarm(&room->grace_timer); // Bežiaci callback miestnosť v stave ACTIVE nezruší
+        sem_wait(room->sem_game_update);
+        room->client_socket = client_socket;
+        outbound_attach(&room->outbound, client_socket); // Pri chybe spojenie len nedostane rámce
+        sem_post(room->sem_game_update);
+    }
+    return room;
+}
+
+int room_with_token(const char *token, void (*callback)(Room *room, void *context), void *context) {
+    int found = 0;
+    pthread_mutex_lock(&rooms_mutex);
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        if (rooms[i].state == ROOM_ACTIVE && strcmp(rooms[i].token, token) == 0) {
+            callback(&rooms[i], context);
+            found = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&rooms_mutex);
+    return found;
+}
+
+// Zruší kanál v zdieľanej pamäti. Volá sa pod sem_game_update.
+static void room_close_shm(Room *room) {
+    if (room->shm) {
+        shm_channel_close(room->shm, room->shm_frame_capacity, room->shm_name);
+        room->shm = NULL;
+    }
+}
+
+int room_open_shm(Room *room, size_t frame_capacity) {
+    if (room->shm) return 0;
+    room->shm = shm_channel_create(room->shm_name, frame_capacity);
+    if (!room->shm) {
+        LOG_WARN("Miestnosť %d: zdieľanú pamäť %s sa nepodarilo vytvoriť: %s",
+                 room->id, room->shm_name, strerror(errno));
+        return -1;
+    }
+    room->shm_frame_capacity = frame_capacity;
+    return 0;
+}
+
+void room_park(Room *room) {
+    sem_wait(room->sem_game_update);
+    room->client_socket = -1;
+    outbound_detach(&room->outbound);
+    room->use_udp = 0; // Po návrate si klient prenos vyjedná znova
+    room->lockstep = 0;
+    room->udp_addr_known = 0;
+    room_close_shm(room);
+    if (!room->suspended) {
+        room->game->player_status.paused = 1;
+    }
+    sem_post(room->sem_game_update);
+    room_wake(room);
+
+    pthread_mutex_lock(&rooms_mutex);
+    room->state = ROOM_PARKED;
+    pthread_mutex_unlock(&rooms_mutex);
+    scheduler_arm(&room->grace_timer, (int64_t)RECONNECT_GRACE_SECONDS * 1000);
+    LOG_INFO("Miestnosť %d čaká %d sekúnd na návrat hráča.", room->id, RECONNECT_GRACE_SECONDS);
+}
+
+void room_destroy(Room *room) {
+    // Od tejto chvíle miestnosť nenájde ani room_with_token
+    pthread_mutex_lock(&rooms_mutex);
+    room->state = ROOM_CLOSING;
+    pthread_mutex_unlock(&rooms_mutex);
+
+    // Po zrušení časovačov už na miestnosť nesiahne žiadny callback
+    scheduler_cancel_sync(&room->tick_timer);
+    scheduler_cancel_sync(&room->time_limit_timer);
+    scheduler_cancel_sync(&room->grace_timer);
+
+    room_detach_arena(room);
+    if (room->suspended) {
+        unlink(room->snapshot_path);
+        room->suspended = 0;
+    }
+    room_close_shm(room);
+    outbound_detach(&room->outbound);
+    sem_close(room->sem_game_update);
+    sem_unlink(room->sem_name);
+
+    pthread_mutex_lock(&rooms_mutex);
+    room->state = ROOM_FREE;
+    pthread_mutex_unlock(&rooms_mutex);
+    METRIC_ADD(active_rooms, -1);
+}
+
+void rooms_cleanup_process(pid_t pid) {
+    char name[256];
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        snprintf(name, sizeof(name), "/game_update_%d_%d", (int)pid, i);
+        sem_unlink(name);
+        snprintf(name, sizeof(name), "/snake_shm_%d_%d", (int)pid, i);
+        shm_unlink(name);
+        snprintf(name, sizeof(name), "%s/snake_room_%d_%d.snap", room_snapshot_dir, (int)pid, i);
+        unlink(name);
+    }
+}
+
+int room_apply_input(Room *room, unsigned int seq, int direction, unsigned long long client_time_us) {
+    if (direction < 0 || direction > 3) {
+        return -1; // Had by sa nepohol a smer by išiel v STEP aj v hashi stavu
+    }
+    change_direction(&room->game->snake, direction);
+    room->last_input_seq = seq;
+    room->last_input_time_us = client_time_us;
+    room->last_input_received_us = scheduler_now_us();
+    return 0;
+}
+
+void room_wake(Room *room) {
+    scheduler_arm(&room->tick_timer, 0);
+}
+
+int room_running(Room *room) {
+    sem_wait(room->sem_game_update);
+    int running = room->suspended || room->game->snake.alive;
+    sem_post(room->sem_game_update);
+    return running;
+}
+
+int room_suspend(Room *room) {
+    if (game_snapshot_save_file(room->game, room->snapshot_path) < 0) {
+        return -1;
+    }
+    room_detach_arena(room);
+    room->suspended = 1;
+    LOG_INFO("Miestnosť %d: hra uložená do snapshotu %s, pamäť uvoľnená.", room->id, room->snapshot_path);
+    return 0;
+}
+
+int room_restore(Room *room) {
+    if (room_attach_arena(room) < 0) {
+        return -1;
+    }
+    if (game_snapshot_load_file_into(room->game, room->snapshot_path, room->arena->grid,
+                                     room->arena->grid_size) < 0) {
+        LOG_ERROR("Nepodarilo sa obnoviť hru zo snapshotu %s.", room->snapshot_path);
+        room->game->obstacles = NULL; // Mriežka patrí aréne
+        room_detach_arena(room);
+        return -1;
+    }
+    unlink(room->snapshot_path);
+    room->suspended = 0;
+    LOG_INFO("Miestnosť %d: hra obnovená zo snapshotu.", room->id);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#ifndef ROOM_H
+#define ROOM_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <netinet/in.h>
+#include "../Game_logic/game_logic.h"
+#include "../Protocol/shm_channel.h"
+#include "interest.h"
+#include "outbound.h"
+#include "room_arena.h"
+#include "timer_wheel.h"
+
+// Makrá
+#define MAX_ROOMS 64
+#define RESUME_TOKEN_LENGTH 32
+#define RECONNECT_GRACE_SECONDS 60 // Ako dlho čaká odpojená hra na návrat hráča
+
+typedef enum {
+    ROOM_FREE = 0, // Voľný slot
+    ROOM_ACTIVE,   // Hráč je pripojený
+    ROOM_PARKED,   // Hráč sa odpojil, hra čaká pozastavená na resume token
+    ROOM_CLOSING   // Miestnosť sa práve ruší
+} RoomState;
+
+typedef struct {
+    int id;
+    RoomState state;
+    Game *game;               // V aréne miestnosti; NULL, ak je hra odložená v snapshote
+    RoomArena *arena;         // Blok s hrou a buffermi, počas odloženia v snapshote vrátený do poolu
+    int width;                // Rozmer hry (na získanie arény pri obnove zo snapshotu)
+    int height;
+    sem_t *sem_game_update;   // Chráni game, client_socket a suspended
+    char sem_name[64];
+    int client_socket;        // -1, ak hráč nie je pripojený
+    int suspended;            // 1, ak je pozastavená hra odložená v snapshote mimo pamäte
+    char snapshot_path[256];
+    char token[RESUME_TOKEN_LENGTH + 1];
+    unsigned int tick;        // Počet odohraných ťahov (číslo rámca)
+    unsigned int last_input_seq; // Sekvencia posledného použitého vstupu (potvrdzuje sa v rámci)
+    unsigned long long last_input_time_us; // Čas klienta pri odoslaní vstupu last_input_seq
+    int64_t last_input_received_us; // Kedy server vstup last_input_seq prijal (scheduler_now_us)
+    unsigned int timed_input_seq; // Vstup, pre ktorý je spočítané input_wait_us
+    unsigned int input_wait_us;   // Od prijatia vstupu timed_input_seq po ťah, ktorý ho použil
+    int64_t tick_start_us;        // Začiatok posledného ťahu
+    int use_udp;              // 1, ak si klient vyjednal UDP prenos vstupov a rámcov
+    struct sockaddr_in udp_addr; // UDP adresa klienta (z jeho posledného paketu)
+    int udp_addr_known;
+    int keyframe_requested;   // Klient žiada celú mapu (keyframe) cez TCP
+    int lockstep;             // Klient simuluje hru sám: namiesto rámcov ide STATE a STEP (game_lockstep.h)
+    ShmChannel *shm;          // Kanál v zdieľanej pamäti pre lokálneho klienta, inak NULL
+    size_t shm_frame_capacity; // Kapacita rámca kanála (mimo zdieľanej pamäte, klient ju nezmení)
+    char shm_name[64];
+    int64_t next_tick_ms;     // Termín ďalšieho ťahu (skoršie prebudenie hada nepohne)
+    Timer tick_timer;         // Ďalší ťah hry (aj odpočet po pauze a spracovanie riadiacich príkazov)
+    Timer time_limit_timer;   // Koniec hry na čas
+    Timer grace_timer;        // Koniec ochrannej lehoty po odpojení hráča
+    char *frame_buffer;       // Vykreslený rámec (v aréne)
+    char *keyframe;           // Posledná celá mapa poslaná v UDP režime cez TCP (v aréne)
+    unsigned int keyframe_tick; // 0 = klient ešte nemá keyframe
+    int terminal_columns;     // Rozmer terminálu klienta (príkaz "view"), 0 = celá mapa
+    int terminal_rows;
+    OutboundQueue outbound;   // Neodoslané správy pre client_socket (chráni sem_game_update)
+    InterestArea view;        // Časť sveta v poslednom rámci (výrez alebo celá mapa)
+} Room;
+
+// Pripraví tabuľku miestností (adresár snapshotov). Volá sa raz pri štarte servera.
+void rooms_init(const char *snapshot_dir);
+
+// Obsadí voľný slot, vezme z poolu arénu pre hru width x height, vytvorí semafor,
+// pripojí k socketu odchádzajúci front a vygeneruje resume token. Hru v room->game potom inicializuje volajúci. Pri chybe vráti NULL.
+Room *room_create(int client_socket, int width, int height);
+
+// Nájde odpojenú miestnosť podľa tokenu a pripojí k nej nového klienta. Inak vráti NULL.
+Room *room_claim(const char *token, int client_socket);
+
+// Nájde pripojenú miestnosť podľa tokenu a zavolá pre ňu callback. Miestnosť sa počas
+// callbacku nemôže zrušiť. Vráti 1, ak sa miestnosť našla.
+int room_with_token(const char *token, void (*callback)(Room *room, void *context), void *context);
+
+// Vytvorí kanál v zdieľanej pamäti pre rámce danej veľkosti. Volá sa pod sem_game_update.
+int room_open_shm(Room *room, size_t frame_capacity);
+
+// Odpojí klienta a ponechá hru pozastavenú počas ochrannej lehoty (potom ju zruší časovač).
+void room_park(Room *room);
+
+// Zastaví časovače miestnosti, uvoľní hru, snapshot aj semafor a uvoľní slot.
+void room_destroy(Room *room);
+
+// Odstráni semafory, zdieľanú pamäť a snapshoty, ktoré po sebe nechal proces pid
+// (napr. spadnutý worker). Volá sa aj pri ukončení servera pre vlastný proces.
+void rooms_cleanup_process(pid_t pid);
+
+// Zmení smer hada podľa vstupu seq a zapamätá si jeho časy pre FrameTiming. Smer mimo 0 - 3
+// (od ktoréhokoľvek prenosu) odmietne a vráti -1. Volá sa pod sem_game_update pre hru,
+// ktorá nie je odložená v snapshote.
+int room_apply_input(Room *room, unsigned int seq, int direction, unsigned long long client_time_us);
+
+// Naplánuje ťah hry okamžite, aby sa hneď spracovala zmena stavu (pauza, pokračovanie, koniec).
+void room_wake(Room *room);
+
+// Zistí pod semaforom, či hra ešte beží (aj pozastavená v snapshote sa počíta).
+int room_running(Room *room);
+
+// Uloží pozastavenú hru do snapshotu a vráti jej arénu do poolu. Volá sa pod sem_game_update.
+int room_suspend(Room *room);
+
+// Načíta hru zo snapshotu do arény z poolu. Volá sa pod sem_game_update.
+int room_restore(Room *room);
+
+#endif // ROOM_H
@@ -0,0 +1,100 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "log.h"
+#include "room_arena.h"
+
+#define ARENA_ALIGN 64
+
+static RoomArena *free_arenas[ROOM_ARENA_CLASSES];
+static int idle_arenas;
+static pthread_mutex_t arenas_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static size_t arena_needed(int width, int height) {
+    return align_up(sizeof(Game)) + align_up(game_grid_size(width, height))
+           + 2 * align_up(room_frame_size(width, height));
+}
+
+// Najmenšia trieda, do ktorej sa zmestí size bajtov, alebo -1.
+static int arena_class(size_t size) {
+    for (int size_class = 0; size_class < ROOM_ARENA_CLASSES; size_class++) {
+        if (size <= (size_t)1 << (ROOM_ARENA_MIN_CLASS + size_class)) return size_class;
+    }
+    return -1;
+}
+
+static RoomArena *arena_allocate(int size_class) {
+    size_t capacity = (size_t)1 << (ROOM_ARENA_MIN_CLASS + size_class);
+    RoomArena *arena = aligned_alloc(ARENA_ALIGN, align_up(sizeof(RoomArena) + capacity));
+    if (!arena) return NULL;
+    arena->next_free = NULL;
+    arena->size_class = size_class;
+    arena->capacity = capacity;
+    return arena;
+}
+
+// Rozloží hru, mriežku a buffery za sebou v bloku arény.
+static void arena_layout(RoomArena *arena, int width, int height) {
+    unsigned char *cursor = arena->block;
+    arena->game = (Game *)cursor;
+    cursor += align_up(sizeof(Game));
+    arena->grid = cursor;
+    arena->grid_size = game_grid_size(width, height);
+    cursor += align_up(arena->grid_size);
+    arena->frame_size = room_frame_size(width, height);
+    arena->frame_buffer = (char *)cursor;
+    cursor += align_up(arena->frame_size);
+    arena->keyframe = (char *)cursor;
+
+    arena->game->obstacles = NULL;
+    arena->game->owns_grid = 0;
+}
+
+void room_arenas_init(void) {
+    int size_class = arena_class(arena_needed(ROOM_ARENA_DEFAULT_WIDTH, ROOM_ARENA_DEFAULT_HEIGHT));
+    for (int i = 0; i < ROOM_ARENA_PREALLOCATED; i++) {
+        RoomArena *arena = arena_allocate(size_class);
+        if (!arena) break;
+        room_arena_release(arena);
+    }
+}
+
+RoomArena *room_arena_acquire(int width, int height) {
+    int size_class = arena_class(arena_needed(width, height));
+    if (size_class < 0) return NULL;
+
+    pthread_mutex_lock(&arenas_mutex);
+    RoomArena *arena = free_arenas[size_class];
+    if (arena) {
+        free_arenas[size_class] = arena->next_free;
+        idle_arenas--;
+    }
+    pthread_mutex_unlock(&arenas_mutex);
+
+    if (!arena) {
+        arena = arena_allocate(size_class);
+        if (!arena) return NULL;
+        LOG_DEBUG("Nová aréna %zu bajtov pre hru %dx%d.", arena->capacity, width, height);
+    }
+    arena_layout(arena, width, height);
+    return arena;
+}
+
+void room_arena_release(RoomArena *arena) {
+    if (!arena) return;
+
+    pthread_mutex_lock(&arenas_mutex);
+    if (idle_arenas < ROOM_ARENA_POOL_MAX) {
+        arena->next_free = free_arenas[arena->size_class];
+        free_arenas[arena->size_class] = arena;
+        idle_arenas++;
+        arena = NULL;
+    }
+    pthread_mutex_unlock(&arenas_mutex);
+
+    free(arena); // Pool je plný
+}
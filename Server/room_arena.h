@@ -0,0 +1,46 @@
+#ifndef ROOM_ARENA_H
+#define ROOM_ARENA_H
+
+#include <stddef.h>
+#include "../Game_logic/game_logic.h"
+
+// Aréna miestnosti: jeden blok pamäte s hrou, mriežkou prekážok a oboma rámcovými buffermi.
+// Skončené hry vracajú arény do poolu rozdeleného podľa veľkostných tried (mocniny dvoch),
+// takže nová hra je len nové rozloženie už alokovaného bloku.
+
+#define ROOM_ARENA_MIN_CLASS 12      // Najmenšia trieda 4 KiB
+#define ROOM_ARENA_CLASSES 14        // Najväčšia trieda 32 MiB
+#define ROOM_ARENA_POOL_MAX 64       // Najviac nečinných arén v poole (ostatné sa uvoľnia)
+#define ROOM_ARENA_PREALLOCATED 8    // Koľko arén sa pripraví pri štarte servera
+#define ROOM_ARENA_DEFAULT_WIDTH 40  // Rozmer, pre ktorý sa pripravia arény pri štarte
+#define ROOM_ARENA_DEFAULT_HEIGHT 20
+#define FRAME_SUMMARY_RESERVE 512    // Miesto za mapou rámca pre súhrn a minimapu výrezu
+
+typedef struct RoomArena {
+    struct RoomArena *next_free; // Ďalšia nečinná aréna rovnakej triedy
+    int size_class;
+    size_t capacity;             // Veľkosť bloku za hlavičkou
+    Game *game;
+    void *grid;                  // Mriežka prekážok (game_grid_size)
+    size_t grid_size;
+    char *frame_buffer;          // Vykreslený rámec
+    char *keyframe;              // Posledný keyframe v UDP režime
+    size_t frame_size;           // Veľkosť každého z rámcových bufferov
+    unsigned char block[];
+} RoomArena;
+
+// Veľkosť rámcového buffera: mapa s koncami riadkov a rezerva pre súhrn pod mapou (aj s minimapou pohľadu).
+static inline size_t room_frame_size(int width, int height) {
+    return (size_t)(width + 1) * (size_t)height + FRAME_SUMMARY_RESERVE;
+}
+
+// Pripraví ROOM_ARENA_PREALLOCATED arén do poolu. Volá sa raz pri štarte (pred forkom workerov).
+void room_arenas_init(void);
+
+// Vezme z poolu (alebo alokuje) arénu pre hru width x height a rozloží ju. Pri chybe vráti NULL.
+RoomArena *room_arena_acquire(int width, int height);
+
+// Vráti arénu do poolu na ďalšie použitie.
+void room_arena_release(RoomArena *arena);
+
+#endif // ROOM_ARENA_H
@@ -0,0 +1,118 @@
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "log.h"
+#include "scheduler.h"
+
+static TimerWheel scheduler_wheel;
+static pthread_mutex_t scheduler_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_changed;   // Nový skorší časovač alebo zastavenie
+static pthread_cond_t scheduler_finished;  // Dobehol callback (pre scheduler_cancel_sync)
+static pthread_t scheduler_thread;
+static int scheduler_running = 0;
+static uint64_t scheduler_sleep_until = UINT64_MAX; // Kedy sa vlákno samo zobudí
+static Timer *scheduler_current = NULL;             // Časovač, ktorého callback práve beží
+
+int64_t scheduler_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int64_t scheduler_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *scheduler_loop(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&scheduler_mutex);
+    while (scheduler_running) {
+        Timer *timer;
+        while (scheduler_running
+               && (timer = timer_wheel_expire(&scheduler_wheel, (uint64_t)scheduler_now_ms())) != NULL) {
+            scheduler_current = timer;
+            pthread_mutex_unlock(&scheduler_mutex);
+            timer->callback(timer->context);
+            pthread_mutex_lock(&scheduler_mutex);
+            scheduler_current = NULL;
+            pthread_cond_broadcast(&scheduler_finished);
+        }
+        if (!scheduler_running) break;
+
+        scheduler_sleep_until = timer_wheel_next_expiry(&scheduler_wheel);
+        if (scheduler_sleep_until == UINT64_MAX) {
+            pthread_cond_wait(&scheduler_changed, &scheduler_mutex);
+        } else {
+            struct timespec deadline = {
+                (time_t)(scheduler_sleep_until / 1000),
+                (long)(scheduler_sleep_until % 1000) * 1000000L
+            };
+            pthread_cond_timedwait(&scheduler_changed, &scheduler_mutex, &deadline);
+        }
+        scheduler_sleep_until = UINT64_MAX;
+    }
+    pthread_mutex_unlock(&scheduler_mutex);
+    return NULL;
+}
+
+int scheduler_start(void) {
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC); // Rovnaké hodiny ako koleso
+    pthread_cond_init(&scheduler_changed, &attributes);
+    pthread_condattr_destroy(&attributes);
+    pthread_cond_init(&scheduler_finished, NULL);
+
+    timer_wheel_init(&scheduler_wheel, (uint64_t)scheduler_now_ms());
+    scheduler_running = 1;
+    if (pthread_create(&scheduler_thread, NULL, scheduler_loop, NULL) != 0) {
+        LOG_ERROR("Failed to create scheduler thread: %s", strerror(errno));
+        scheduler_running = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void scheduler_stop(void) {
+    pthread_mutex_lock(&scheduler_mutex);
+    int running = scheduler_running;
+    scheduler_running = 0;
+    pthread_cond_signal(&scheduler_changed);
+    pthread_mutex_unlock(&scheduler_mutex);
+    if (running) {
+        pthread_join(scheduler_thread, NULL);
+    }
+}
+
+void scheduler_arm(Timer *timer, int64_t delay_ms) {
+    uint64_t expires_ms = (uint64_t)(scheduler_now_ms() + (delay_ms > 0 ? delay_ms : 0));
+    pthread_mutex_lock(&scheduler_mutex);
+    timer_wheel_add(&scheduler_wheel, timer, expires_ms);
+    // Vlákno sa budí len vtedy, keď spí dlhšie, než je nový termín
+    if (expires_ms < scheduler_sleep_until) {
+        pthread_cond_signal(&scheduler_changed);
+    }
+    pthread_mutex_unlock(&scheduler_mutex);
+}
+
+void scheduler_disarm(Timer *timer) {
+    pthread_mutex_lock(&scheduler_mutex);
+    timer_wheel_remove(&scheduler_wheel, timer);
+    pthread_mutex_unlock(&scheduler_mutex);
+}
+
+void scheduler_cancel_sync(Timer *timer) {
+    pthread_mutex_lock(&scheduler_mutex);
+    timer_wheel_remove(&scheduler_wheel, timer);
+    if (!pthread_equal(pthread_self(), scheduler_thread)) {
+        while (scheduler_current == timer) {
+            pthread_cond_wait(&scheduler_finished, &scheduler_mutex);
+            // Dobehnutý callback sa mohol znova naplánovať
+            timer_wheel_remove(&scheduler_wheel, timer);
+        }
+    }
+    pthread_mutex_unlock(&scheduler_mutex);
+}
@@ -0,0 +1,33 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "timer_wheel.h"
+
+// Jedno plánovacie vlákno pre všetky miestnosti procesu: ťahy, časový limit, odpočet po
+// pauze aj ochrannú lehotu po odpojení spúšťa časové koleso namiesto vlákna a spánku
+// na každú miestnosť. Callbacky bežia na plánovacom vlákne postupne, bez zámku plánovača,
+// takže môžu časovače znova plánovať.
+
+// Spustí plánovacie vlákno. Vráti 0 pri úspechu.
+int scheduler_start(void);
+
+// Zastaví plánovacie vlákno (naplánované časovače sa už nespustia).
+void scheduler_stop(void);
+
+// Monotónny čas v milisekundách, v ktorom plánovač počíta.
+int64_t scheduler_now_ms(void);
+
+// Rovnaké hodiny v mikrosekundách (meranie oneskorenia vstupov a rámcov).
+int64_t scheduler_now_us(void);
+
+// Naplánuje (alebo presunie) časovač o delay_ms od teraz. 0 = čo najskôr.
+void scheduler_arm(Timer *timer, int64_t delay_ms);
+
+// Zruší naplánovaný časovač. Nečaká, ak jeho callback práve beží.
+void scheduler_disarm(Timer *timer);
+
+// Zruší časovač a počká, kým jeho bežiaci callback skončí. Volajúci nesmie držať zámok,
+// na ktorý callback čaká. Z callbacku na plánovacom vlákne sa nečaká.
+void scheduler_cancel_sync(Timer *timer);
+
+#endif // SCHEDULER_H
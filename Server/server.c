@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -6,176 +8,709 @@
 #include <pthread.h>
 #include <fcntl.h>
 #include <semaphore.h>
+#include <poll.h>
+#include <signal.h>
 #include "../Game_logic/game_logic.h"
+#include "../Game_logic/game_items.h"
+#include "../Game_logic/game_hash.h"
+#include "../Game_logic/game_lockstep.h"
+#include "../Game_logic/game_snapshot.h"
+#include "../Game_logic/trace.h"
+#include "../Protocol/protocol.h"
+#include "../Protocol/verify_protocol.h"
+#include "log.h"
+#include "room.h"
+#include "scheduler.h"
+#include "supervisor.h"
+#include "udp_transport.h"
+#include "verify_engine.h"
 #include "server.h"
 
 #define PORT 45544
 #define BUFFER_SIZE 1024
 
-Game *game;
-sem_t *sem_game_update;
+void viewport_size(const Game *game, int columns, int rows, int *view_width, int *view_height) {
+    // Neznámy terminál alebo mapa, ktorá sa zmestí celá aj so súhrnom
+    if (columns <= 0 || rows <= 0 || (game->width < columns && game->height + 3 <= rows)) {
+        *view_width = game->width;
+        *view_height = game->height;
+        return;
+    }
+    // Pod výrezom je riadok polohy, minimapa, súhrn a riadok kurzora klienta
+    int width = columns - 1;
+    int height = rows - VIEWPORT_MINIMAP_HEIGHT - 4;
+    if (width < VIEWPORT_MIN_SIZE) width = VIEWPORT_MIN_SIZE;
+    if (height < VIEWPORT_MIN_SIZE) height = VIEWPORT_MIN_SIZE;
+    *view_width = width < game->width ? width : game->width;
+    *view_height = height < game->height ? height : game->height;
+}
+
+int draw_viewport_to_buffer(const Game *game, const InterestArea *view, char *buffer, size_t size) {
+    if (view->width >= game->width && view->height >= game->height) {
+        return draw_game_to_buffer(game, buffer, size);
+    }
 
-void draw_game_to_buffer(const Game *game, char *buffer) {
+    // Výrez z oblasti záujmu: cena rámca závisí od terminálu, nie od veľkosti sveta
+    Point head = game->snake.body[0];
+    int origin_x = view->origin_x, origin_y = view->origin_y;
+    int view_width = view->width, view_height = view->height;
+    int row_length = view_width + 1;
     int index = 0;
-    for (int y = 0; y < game->height; y++) {
-        for (int x = 0; x < game->width; x++) {
-            if (x == 0 || x == game->width - 1 || y == 0 || y == game->height - 1) {
-                buffer[index++] = '#';
-            } else if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[y][x] == 1) {
-                buffer[index++] = '#';
-            } else if (points_equal(game->fruit, (Point){x, y})) {
-                buffer[index++] = 'F';
-            } else {
-                int is_snake = 0;
-                for (int i = 0; i < game->snake.length; i++) {
-                    if (points_equal(game->snake.body[i], (Point){x, y})) {
-                        is_snake = 1;
-                        break;
-                    }
-                }
-                buffer[index++] = is_snake ? 'O' : '.';
-            }
+    for (int y = 0; y < view_height; y++) {
+        for (int x = 0; x < view_width; x++) {
+            buffer[index++] = game_map_symbol(game, origin_x + x, origin_y + y);
         }
-        buffer[index++] = '\n'; // Ukončenie riadku
+        buffer[index++] = '\n';
     }
-    // Pridanie informácií o ovocí a dĺžke hry
-    int fruits_eaten = game->snake.length - 1;
-    int game_duration = (int)(difftime(time(NULL), game->start_time) - game->total_pause_time);
 
-    index += snprintf(buffer + index, BUFFER_SIZE - index,
-                      "Ovocie: %d\nDĺžka hry: %d sekúnd\n",
-                      fruits_eaten, game_duration);
+    // Minimapa: celý svet zmenšený na pár znakov s výrezom (:), telom (o) a hlavou (@)
+    int minimap_width = game->width < VIEWPORT_MINIMAP_WIDTH ? game->width : VIEWPORT_MINIMAP_WIDTH;
+    int minimap_height = game->height < VIEWPORT_MINIMAP_HEIGHT ? game->height : VIEWPORT_MINIMAP_HEIGHT;
+    char minimap[VIEWPORT_MINIMAP_HEIGHT][VIEWPORT_MINIMAP_WIDTH];
+    for (int my = 0; my < minimap_height; my++) {
+        int y0 = my * game->height / minimap_height, y1 = (my + 1) * game->height / minimap_height;
+        int rows_inside = y1 > origin_y && y0 < origin_y + view_height;
+        for (int mx = 0; mx < minimap_width; mx++) {
+            int x0 = mx * game->width / minimap_width, x1 = (mx + 1) * game->width / minimap_width;
+            minimap[my][mx] = rows_inside && x1 > origin_x && x0 < origin_x + view_width ? ':' : '.';
+        }
+    }
+
+    for (int i = game->snake.length - 1; i >= 0; i--) {
+        Point part = game->snake.body[i];
+        int x = part.x - origin_x, y = part.y - origin_y;
+        if (interest_contains(view, part.x, part.y)) {
+            char *cell = &buffer[y * row_length + x];
+            if (*cell == '.') *cell = 'O';
+        }
+        minimap[part.y * minimap_height / game->height][part.x * minimap_width / game->width] = i == 0 ? '@' : 'o';
+    }
 
-    buffer[index] = '\0'; // Null terminátor
+    index += snprintf(buffer + index, size - index, "Výrez %d,%d %dx%d, svet %dx%d, hlava %d,%d\n",
+                      origin_x, origin_y, view_width, view_height, game->width, game->height, head.x, head.y);
+    for (int my = 0; my < minimap_height; my++) {
+        memcpy(buffer + index, minimap[my], (size_t)minimap_width);
+        index += minimap_width;
+        buffer[index++] = '\n';
+    }
+    return game_draw_summary(game, buffer, index, size);
 }
 
-// Thread to handle game updates
-void *game_update_thread(void *arg) {
-    int client_socket = *(int *)arg;
-    char game_buffer[BUFFER_SIZE];
-    printf("Game update thread started.\n");
+// Posunie oblasť záujmu klienta za hlavou a vykreslí ju. Volá sa pod sem_game_update.
+static int draw_room_frame(Room *room) {
+    int view_width, view_height;
+    viewport_size(room->game, room->terminal_columns, room->terminal_rows, &view_width, &view_height);
+    if (interest_follow(&room->view, room->game->snake.body[0], view_width, view_height,
+                        room->game->width, room->game->height)) {
+        // Posunutý výrez by sa líšil od keyframe skoro v každom políčku, nový keyframe je menší
+        room->keyframe_requested = 1;
+    }
+    return draw_viewport_to_buffer(room->game, &room->view, room->frame_buffer, room->arena->frame_size);
+}
 
-    while (game->snake.alive) {
-        sem_wait(sem_game_update);
+// Použije vstupy, ktoré lokálny klient zaradil do fronty v zdieľanej pamäti.
+static void apply_shm_inputs(Room *room) {
+    unsigned int seq;
+    int direction;
+    uint64_t sent_us;
+    while (shm_channel_pop_input(room->shm, &seq, &direction, &sent_us)) {
+        room_apply_input(room, seq, direction, sent_us);
+        // Klient na tom istom stroji má rovnaké monotónne hodiny, vstup čakal od odoslania
+        room->last_input_received_us = (int64_t)sent_us;
+    }
+}
 
-        if (!game->player_status.active) {
-            printf("Hráč sa odpojil. Had vymazaný.\n");
-            sem_post(sem_game_update);
-            break;
-        }
+// Časy k práve odohranému ťahu pre meranie oneskorenia na klientovi.
+static FrameTiming room_frame_timing(const Room *room) {
+    FrameTiming timing = {
+        room->last_input_time_us,
+        room->input_wait_us,
+        (unsigned int)(scheduler_now_us() - room->tick_start_us)
+    };
+    return timing;
+}
 
-        if (game->player_status.paused) {
-            if (!game->paused_message_sent) {
-                printf("Hra zastavená. Čakanie kým hráč obnoví hru...\n");
-                game->paused_message_sent = 1;
-                game->pause_start = time(NULL); // Zaznamenaj začiatok pauzy
-            }
-            sem_post(sem_game_update);
-            sleep(1);
-            continue;
-        } else if (game->paused_message_sent) {
-            time_t pause_end = time(NULL); // Zaznamenaj koniec pauzy
-            game->total_pause_time += difftime(pause_end, game->pause_start); // Pripočítaj čas pauzy
-            printf("Hra zastavená. Čakanie, pohyb začne o 3 sekundy...\n");
-            game->paused_message_sent = 0;
-            sem_post(sem_game_update);
-            sleep(3);
-            continue;
-        }
+// Pošle rámec klientovi. V UDP režime ide len rozdiel voči poslednému keyframe; celá mapa
+// sa posiela cez TCP pri prvom rámci, na žiadosť klienta, každých KEYFRAME_INTERVAL ťahov
+// a vtedy, keď sa rozdiel nezmestí do jedného datagramu. Volá sa pod sem_game_update.
+static void send_frame(Room *room, const char *frame, int frame_length) {
+    FrameTiming timing = room_frame_timing(room);
+    if (room->shm) {
+        // Lokálny klient si rámec prečíta priamo zo zdieľanej pamäte
+        shm_channel_publish(room->shm, room->shm_frame_capacity, room->tick, room->last_input_seq, &timing, frame, frame_length);
+        METRIC_ADD(frames_sent, 1);
+        return;
+    }
+    if (room->client_socket < 0) return;
+    METRIC_ADD(frames_sent, 1);
 
-        printf("Game update semaphore acquired.\n");
+    if (room->use_udp && !room->keyframe_requested && room->keyframe_tick != 0
+        && room->tick - room->keyframe_tick < KEYFRAME_INTERVAL
+        && udp_send_delta(room, &timing, room->keyframe, room->keyframe_tick, frame, frame_length) == 0) {
+        return;
+    }
 
-        printf("\033[H\033[J");
+    outbound_frame(&room->outbound, room->tick, room->last_input_seq, &timing, game_hash(room->game), frame,
+                   frame_length);
+    if (room->use_udp) {
+        memcpy(room->keyframe, frame, (size_t)frame_length + 1);
+        room->keyframe_tick = room->tick;
+        room->keyframe_requested = 0;
+    }
+}
 
-        if (game->mode == TIMED) {
-            time_t current_time = time(NULL);
-            if (difftime(current_time, game->start_time) >= game->time_limit) {
-                printf("Čas vypršal! Hra skončila.\n");
-                game->snake.alive = 0;
-            }
-        }
+// Pošle lockstep klientovi celý stav hry, od ktorého simuluje ďalej. Volá sa pod sem_game_update.
+static void send_state(Room *room) {
+    size_t size = game_snapshot_size(room->game);
+    char *state = malloc(size);
+    if (!state) {
+        LOG_WARN("Miestnosť %d: stav pre lockstep klienta sa nedá pripraviť.", room->id);
+        return;
+    }
+    size_t length = lockstep_write_state(room->game, game_clock_ms(), state, size);
+    if (length > 0) {
+        outbound_message_timed(&room->outbound, MSG_STATE, room->tick, room->last_input_seq, NULL,
+                               game_hash(room->game), state, (int)length);
+    }
+    free(state);
+}
 
-        if (game->snake.alive && !move_snake(game)) {
-            printf("Hra skončila: Had narazil do prekážky alebo do seba.\n");
-            game->snake.alive = 0;
-        }
+// Pošle lockstep klientovi smer hada v práve odohranom ťahu a čas do ďalšieho ťahu.
+// Správy STEP sa na rozdiel od rámcov nenahrádzajú, klient potrebuje každý ťah.
+static void send_step(Room *room, int64_t interval_ms) {
+    char step[32];
+    int length = snprintf(step, sizeof(step), "%d %lld", room->game->snake.direction, (long long)interval_ms);
+    FrameTiming timing = room_frame_timing(room);
+    outbound_message_timed(&room->outbound, MSG_STEP, room->tick, room->last_input_seq, &timing,
+                           game_hash(room->game), step, length);
+    METRIC_ADD(frames_sent, 1);
+}
 
-        if (!game->snake.alive) {
-            snprintf(game_buffer, BUFFER_SIZE, "Hra skončila! Zjedeného ovocia: %d\n",
-                     game->snake.length - 1);
-            send(client_socket, game_buffer, strlen(game_buffer), 0);
-            break;
+// Ukončí hru a pošle hráčovi skóre. Volá sa pod sem_game_update.
+static void finish_game(Room *room) {
+    char message[128];
+    room->game->snake.alive = 0;
+    int length = snprintf(message, sizeof(message), "Hra skončila! Zjedeného ovocia: %d\n",
+                          room->game->fruits_eaten);
+    outbound_message(&room->outbound, MSG_END, 0, 0, message, length);
+}
+
+// Naplánuje koniec hry na čas podľa zostávajúceho odohraného času. Volá sa pod sem_game_update.
+static void arm_time_limit(Room *room) {
+    if (room->game->mode != TIMED) return;
+    int64_t limit_ms = (int64_t)room->game->time_limit * 1000;
+    scheduler_arm(&room->time_limit_timer, limit_ms - game_elapsed_ms(room->game, game_clock_ms()));
+}
+
+// Naplánuje ďalší ťah na absolútny čas (monotónne hodiny). Volá sa pod sem_game_update.
+static void schedule_tick(Room *room, int64_t at_ms) {
+    room->next_tick_ms = at_ms;
+    scheduler_arm(&room->tick_timer, at_ms - scheduler_now_ms());
+}
+
+// Koniec hry na čas. Beží na plánovacom vlákne.
+static void room_time_limit(void *context) {
+    Room *room = context;
+    TRACE_ROOM(room->id);
+
+    sem_wait(room->sem_game_update);
+    // Počas pauzy sa limit neuplatní, po obnovení hry sa naplánuje znova na zvyšný čas
+    if (!room->suspended && room->game->snake.alive && room->game->player_status.active
+        && !room->game->player_status.paused && !room->game->paused_message_sent) {
+        LOG_INFO("Miestnosť %d: čas vypršal! Hra skončila.", room->id);
+        finish_game(room);
+    }
+    sem_post(room->sem_game_update);
+}
+
+// Jeden ťah hry. Beží na plánovacom vlákne; ďalší ťah si naplánuje sám, kým hra beží.
+static void room_tick(void *context) {
+    Room *room = context;
+    int64_t now_ms = scheduler_now_ms();
+    TRACE_ROOM(room->id);
+    TRACE_POLL();
+    TRACE_BEGIN(lock_wait);
+    sem_wait(room->sem_game_update);
+    TRACE_END(lock_wait);
+    TRACE_BEGIN(tick);
+
+    Game *game = room->game;
+    if (room->suspended || !game->snake.alive) {
+        // Hra odložená v snapshote alebo skončená hra ďalší ťah nepotrebuje
+    } else if (!game->player_status.active) {
+        LOG_INFO("Miestnosť %d: hráč sa odpojil. Had vymazaný.", room->id);
+    } else if (game->player_status.paused) {
+        if (!game->paused_message_sent) {
+            LOG_INFO("Miestnosť %d: hra zastavená. Čakanie kým hráč obnoví hru...", room->id);
+            game->paused_message_sent = 1;
+            game->pause_start_ms = game_clock_ms(); // Zaznamenaj začiatok pauzy
         }
+        // Pozastavená hra nepotrebuje pamäť ani časovače - odloží sa do snapshotu.
+        // Ak sa to nepodarí, ostane v pamäti; ďalší ťah naplánuje až pokračovanie.
+        room_suspend(room);
+    } else if (game->paused_message_sent) {
+        game->total_pause_ms += game_clock_ms() - game->pause_start_ms; // Pripočítaj čas pauzy
+        LOG_INFO("Miestnosť %d: hra obnovená, pohyb začne o 3 sekundy...", room->id);
+        game->paused_message_sent = 0;
+        arm_time_limit(room);
+        if (room->lockstep) {
+            send_state(room); // Klient počas pauzy nesimuloval, čas hry sa zosynchronizuje
+        }
+        // Odpočet pred pohybom je len posunutý termín ďalšieho ťahu
+        schedule_tick(room, now_ms + RESUME_COUNTDOWN_MS);
+    } else if (now_ms < room->next_tick_ms) {
+        // Prebudenie riadiacim príkazom pred termínom ťahu, had sa ešte nehýbe
+        schedule_tick(room, room->next_tick_ms);
+    } else {
+        LOG_DEBUG("Miestnosť %d: ťah %u.", room->id, room->tick + 1);
+        room->tick_start_us = scheduler_now_us();
 
-        if (points_equal(game->snake.body[0], game->fruit)) {
-            game->snake.length += 1;
-            generate_fruit(game);
+        if (room->shm) {
+            apply_shm_inputs(room);
+        }
+        if (room->last_input_seq != room->timed_input_seq) {
+            // Vstup sa prejaví v tomto ťahu: doba, ktorú na serveri čakal na ťah
+            room->input_wait_us = (unsigned int)(room->tick_start_us - room->last_input_received_us);
+            room->timed_input_seq = room->last_input_seq;
         }
 
-        draw_game_to_buffer(game, game_buffer);
-        send(client_socket, game_buffer, strlen(game_buffer), 0); // Odoslanie hernej mapy
+        TRACE_BEGIN(move_snake);
+        int moved = move_snake(game);
+        TRACE_END(move_snake);
 
-        sem_post(sem_game_update);
-        sleep(2);
+        if (!moved) {
+            LOG_INFO("Miestnosť %d: hra skončila, had narazil do prekážky alebo do seba.", room->id);
+            finish_game(room);
+        } else {
+            // Predmet pod hlavou je jedno čítanie mriežky bez ohľadu na počet predmetov
+            TRACE_BEGIN(generate_fruit);
+            game_collect_item(game);
+            TRACE_END(generate_fruit);
+
+            room->tick++;
+            int64_t interval_ms = game->speed_ticks > 0 ? TICK_INTERVAL_MS / 2 : TICK_INTERVAL_MS;
+
+            if (room->lockstep) {
+                // Mapu si klient odsimuluje a vykreslí sám, stačí mu smer ťahu
+                TRACE_BEGIN(send);
+                send_step(room, interval_ms);
+                TRACE_END(send);
+            } else {
+                TRACE_BEGIN(render);
+                int frame_length = draw_room_frame(room);
+                TRACE_END(render);
+
+                // Odoslanie hernej mapy; potvrdenie vstupov ide v hlavičke rámca
+                TRACE_BEGIN(send);
+                send_frame(room, room->frame_buffer, frame_length);
+                TRACE_END(send);
+            }
+
+            // Termín sa počíta od začiatku ťahu, aby sa interval nepredlžoval o čas spracovania
+            schedule_tick(room, now_ms + interval_ms);
+        }
     }
 
-    printf("Game update thread finished.\n");
-    return NULL;
+    TRACE_END(tick);
+    sem_post(room->sem_game_update);
+}
+
+// Pripraví časovače novej miestnosti a naplánuje prvý ťah.
+static void start_room_timers(Room *room) {
+    timer_init(&room->tick_timer, room_tick, room);
+    timer_init(&room->time_limit_timer, room_time_limit, room);
+    room->next_tick_ms = 0;
 }
 
 void cleanup_resources(int server_fd, int client_socket) {
     if (server_fd >= 0) close(server_fd);
     if (client_socket >= 0) close(client_socket);
-    if (sem_game_update) {
-        sem_close(sem_game_update);
-        sem_unlink("/game_update");
+}
+
+// Spracuje jeden príkaz od klienta. Vráti 1, ak hráč hru ukončil.
+static int apply_client_command(Room *room, const char *command) {
+    sem_t *sem_game_update = room->sem_game_update;
+    unsigned int seq;
+    unsigned long long client_time_us = 0;
+    int new_direction, columns, rows;
+
+    if (strcmp(command, "pause") == 0) {
+        sem_wait(sem_game_update);
+        if (!room->suspended) {
+            room->game->player_status.paused = 1;
+        }
+        sem_post(sem_game_update);
+        room_wake(room);
+    } else if (strcmp(command, "quit") == 0) {
+        sem_wait(sem_game_update);
+        if (!room->suspended) {
+            room->game->player_status.active = 0;
+        }
+        sem_post(sem_game_update);
+        room_wake(room);
+        return 1;
+    } else if (strcmp(command, "resume") == 0) {
+        // Odpočet pred obnovením pohybu si naplánuje vlákno hry, vstupy sa čítajú ďalej
+        sem_wait(sem_game_update);
+        if (room->suspended) {
+            room_restore(room);
+        }
+        if (!room->suspended) {
+            room->game->player_status.paused = 0;
+        }
+        sem_post(sem_game_update);
+        room_wake(room);
+    } else if (strcmp(command, "transport udp") == 0) {
+        // Bez UDP socketu server odpovie "tcp" a rámce idú ďalej cez TCP
+        char reply[32];
+        int length;
+        sem_wait(sem_game_update);
+        if (udp_transport_port() > 0) {
+            room->use_udp = 1;
+            room->keyframe_requested = 1;
+            length = snprintf(reply, sizeof(reply), "udp %d", udp_transport_port());
+        } else {
+            length = snprintf(reply, sizeof(reply), "tcp");
+        }
+        outbound_message(&room->outbound, MSG_TRANSPORT, 0, 0, reply, length);
+        sem_post(sem_game_update);
+    } else if (strcmp(command, "transport shm") == 0) {
+        // Kanál sa dimenzuje podľa mapy, pre hru odloženú v snapshote ostáva TCP
+        char reply[96];
+        int length;
+        sem_wait(sem_game_update);
+        if (!room->suspended && room_open_shm(room, room_frame_size(room->game->width, room->game->height)) == 0) {
+            room->use_udp = 0;
+            length = snprintf(reply, sizeof(reply), "shm %s", room->shm_name);
+        } else {
+            length = snprintf(reply, sizeof(reply), "tcp");
+        }
+        outbound_message(&room->outbound, MSG_TRANSPORT, 0, 0, reply, length);
+        sem_post(sem_game_update);
+    } else if (strcmp(command, "transport lockstep") == 0) {
+        // Hru odloženú v snapshote klient dostane až po obnovení (STATE po pauze)
+        sem_wait(sem_game_update);
+        room->use_udp = 0;
+        room->lockstep = 1;
+        outbound_message(&room->outbound, MSG_TRANSPORT, 0, 0, "lockstep", 8);
+        if (!room->suspended) {
+            send_state(room);
+        }
+        sem_post(sem_game_update);
+    } else if (sscanf(command, "view %d %d", &columns, &rows) == 2) {
+        // Nový rozmer terminálu: výrez sa zmení, takže ďalší rámec musí byť keyframe
+        sem_wait(sem_game_update);
+        room->terminal_columns = columns;
+        room->terminal_rows = rows;
+        room->keyframe_requested = 1;
+        sem_post(sem_game_update);
+    } else if (strcmp(command, "keyframe") == 0) {
+        sem_wait(sem_game_update);
+        room->keyframe_requested = 1;
+        if (room->lockstep && !room->suspended) {
+            send_state(room); // Lockstep klient sa rozišiel so serverom alebo vypadol z kruhu snapshotov
+        }
+        sem_post(sem_game_update);
+    } else if (sscanf(command, "move %u %d %llu", &seq, &new_direction, &client_time_us) >= 2) {
+        // Zmena smeru sa potvrdí až v hlavičke najbližšieho rámca (čas klienta je nepovinný)
+        sem_wait(sem_game_update);
+        if (!room->suspended && room_apply_input(room, seq, new_direction, client_time_us) < 0) {
+            LOG_WARN("Miestnosť %d: neplatný smer %d od klienta.", room->id, new_direction);
+        }
+        sem_post(sem_game_update);
+    } else {
+        LOG_WARN("Miestnosť %d: neznámy príkaz od klienta: %s", room->id, command);
     }
-    if (game) {
-        for (int i = 0; i < game->height; i++) {
-            free(game->obstacles[i]);
+    return 0;
+}
+
+// Spracúva vstupy pripojeného hráča a dopisuje jeho odchádzajúci front, kým hra beží.
+// Vráti 1, ak sa hráč odpojil uprostred hry.
+static int handle_client_input(Room *room, int client_socket, StreamReader *reader) {
+    TRACE_ROOM(room->id);
+    struct pollfd fds[2] = {{client_socket, POLLIN, 0}, {room->outbound.wake_fd, POLLIN, 0}};
+
+    while (room_running(room)) {
+        // Najprv sa spracujú všetky celé príkazy, ktoré už sú v bufferi
+        TRACE_BEGIN(input);
+        char *command;
+        while ((command = stream_reader_next_line(reader)) != NULL) {
+            LOG_DEBUG("Miestnosť %d: received from client: %s", room->id, command);
+            if (apply_client_command(room, command)) {
+                TRACE_END(input);
+                return 0;
+            }
+        }
+        TRACE_END(input);
+
+        // Socket je neblokujúci: čaká sa na vstup, na zobudenie ťahom a pri plnom fronte aj na zápis
+        sem_wait(room->sem_game_update);
+        fds[0].events = POLLIN | (outbound_pending(&room->outbound) ? POLLOUT : 0);
+        sem_post(room->sem_game_update);
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_WARN("Miestnosť %d: poll failed: %s", room->id, strerror(errno));
+            return room_running(room);
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t wakeups;
+            ssize_t ignored = read(fds[1].fd, &wakeups, sizeof(wakeups));
+            (void)ignored;
+        }
+        if (fds[0].revents & POLLOUT) {
+            sem_wait(room->sem_game_update);
+            outbound_flush(&room->outbound);
+            sem_post(room->sem_game_update);
+        }
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+        int bytes_read = stream_reader_fill(reader, client_socket);
+        TRACE_POLL();
+        if (bytes_read == 0) {
+            LOG_INFO("Miestnosť %d: client disconnected.", room->id);
+            return room_running(room);
+        } else if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            continue;
+        } else if (bytes_read < 0 && errno == EMSGSIZE) {
+            LOG_WARN("Miestnosť %d: klient poslal príkaz dlhší ako %d bajtov, spojenie sa ukončí.",
+                     room->id, CLIENT_READER_MAX_SIZE);
+            return room_running(room);
+        } else if (bytes_read < 0) {
+            LOG_WARN("Miestnosť %d: error reading from client: %s", room->id, strerror(errno));
+            return room_running(room);
         }
-        free(game->obstacles);
-        free(game);
     }
+    return 0;
 }
 
-int main() {
-    int server_fd, client_socket;
-    struct sockaddr_in address;
-    int addrlen = sizeof(address);
+// Založí novú miestnosť podľa nastavení od klienta.
+static Room *start_new_room(int client_socket, const char *settings) {
+    int width, height, game_mode, time_limit, world_type, fruits = 1;
+    // Šiesta hodnota (počet ovocí naraz) je nepovinná
+    if (sscanf(settings, "%d %d %d %d %d %d", &width, &height, &game_mode, &time_limit, &world_type, &fruits) < 5) {
+        LOG_WARN("Failed to receive game settings from client.");
+        return NULL;
+    }
+    if (fruits < 1) fruits = 1;
+    if (fruits > MAX_FRUITS) fruits = MAX_FRUITS;
+
+    if (width < MIN_WORLD_SIZE || width > MAX_WORLD_SIZE || height < MIN_WORLD_SIZE || height > MAX_WORLD_SIZE) {
+        LOG_WARN("Neplatný rozmer hry %dx%d.", width, height);
+        return NULL;
+    }
+
+    Room *room = room_create(client_socket, width, height);
+    if (!room) {
+        return NULL;
+    }
+    start_room_timers(room);
+    // Hra aj mriežka sa rozložia do arény miestnosti, nič sa nealokuje
+    initialize_game_in(room->game, room->arena->grid, width, height, game_mode, time_limit, world_type,
+                       (uint32_t)time(NULL));
+    room->game->fruit_target = fruits;
+    while (room->game->item_counts[ITEM_FRUIT] < fruits && game_spawn_item(room->game, ITEM_FRUIT) == 0) {
+    }
+    LOG_INFO("Game initialized: Room=%d, Width=%d, Height=%d, Mode=%d, Time Limit=%d, World Type=%d, Fruits=%d",
+           room->id, width, height, game_mode, time_limit, world_type, fruits);
+
+    sem_wait(room->sem_game_update);
+    // Token pre opätovné pripojenie ide klientovi ešte pred prvou mapou
+    outbound_message(&room->outbound, MSG_TOKEN, 0, 0, room->token, RESUME_TOKEN_LENGTH);
+    arm_time_limit(room);
+    room_wake(room); // Prvý ťah hneď
+    sem_post(room->sem_game_update);
+    return room;
+}
+
+// Pripojí klienta späť k odpojenej hre a pošle mu aktuálny stav (keyframe).
+static Room *resume_room(int client_socket, const char *token) {
+    Room *room = room_claim(token, client_socket);
+    if (!room) {
+        LOG_WARN("Neplatný alebo expirovaný resume token.");
+        return NULL;
+    }
+
+    sem_wait(room->sem_game_update);
+    int ok = 1;
+    if (room->suspended) {
+        ok = room_restore(room) == 0;
+    }
+    if (ok) {
+        room->game->player_status.paused = 0;
+        room_wake(room);
+        outbound_message(&room->outbound, MSG_TOKEN, 0, 0, room->token, RESUME_TOKEN_LENGTH);
+
+        int frame_length = draw_room_frame(room);
+        outbound_frame(&room->outbound, room->tick, room->last_input_seq, NULL, game_hash(room->game),
+                       room->frame_buffer, frame_length);
+    }
+    sem_post(room->sem_game_update);
+
+    if (!ok) {
+        room_destroy(room);
+        return NULL;
+    }
+    LOG_INFO("Hráč sa vrátil do miestnosti %d.", room->id);
+    return room;
+}
+
+// Nové spojenie: socket a bajty, ktoré z neho už prečítal iný worker pred odovzdaním.
+typedef struct {
+    int socket;
+    size_t initial_length;
+    char initial[BUFFER_SIZE];
+} ClientConnection;
+
+// Odovzdá spojenie s resume tokenom cudzieho workera jeho vlastníkovi. Vráti 1, ak sa to podarilo.
+static int forward_to_owner(int client_socket, const char *token, StreamReader *reader) {
+    int owner = token_owner(token);
+    if (worker_index < 0 || owner < 0 || owner == worker_index) return 0;
+
+    char data[BUFFER_SIZE];
+    size_t rest = reader->size - reader->consumed;
+    int length = snprintf(data, sizeof(data), "resume %s\n", token);
+    if ((size_t)length + rest > sizeof(data)) return 0;
+    memcpy(data + length, reader->data + reader->consumed, rest);
+
+    if (worker_handoff_send(owner, client_socket, data, (size_t)length + rest) < 0) {
+        LOG_WARN("Spojenie sa nepodarilo odovzdať workerovi %d: %s", owner, strerror(errno));
+        return 0;
+    }
+    METRIC_ADD(handoffs, 1);
+    LOG_DEBUG("Spojenie odovzdané workerovi %d.", owner);
+    return 1;
+}
+
+// Vlákno jedného pripojenia: nová hra alebo návrat do existujúcej pomocou tokenu.
+static void *client_thread(void *arg) {
+    ClientConnection *connection = arg;
+    int client_socket = connection->socket;
     char buffer[BUFFER_SIZE];
+    StreamReader reader;
+
+    int reader_ok = stream_reader_init(&reader) == 0;
+    reader.max_size = CLIENT_READER_MAX_SIZE; // Klient bez konca riadku nesmie zväčšovať buffer donekonečna
+    if (!reader_ok || stream_reader_append(&reader, connection->initial, connection->initial_length) < 0) {
+        free(connection);
+        stream_reader_free(&reader);
+        cleanup_resources(-1, client_socket);
+        return NULL;
+    }
+    free(connection);
+
+    // Prvý riadok sú nastavenia novej hry alebo "resume <token>"
+    char *first_line;
+    while ((first_line = stream_reader_next_line(&reader)) == NULL) {
+        if (reader.size >= BUFFER_SIZE || stream_reader_fill(&reader, client_socket) <= 0) {
+            LOG_WARN("Failed to receive game settings from client.");
+            stream_reader_free(&reader);
+            cleanup_resources(-1, client_socket);
+            return NULL;
+        }
+    }
+
+    Room *room;
+    if (strncmp(first_line, "resume ", 7) == 0) {
+        // Miestnosť môže patriť inému workerovi, ktorý zdieľa rovnaký port
+        if (forward_to_owner(client_socket, first_line + 7, &reader)) {
+            stream_reader_free(&reader);
+            cleanup_resources(-1, client_socket);
+            return NULL;
+        }
+        room = resume_room(client_socket, first_line + 7);
+    } else {
+        room = start_new_room(client_socket, first_line);
+    }
+    if (!room) {
+        stream_reader_free(&reader);
+        cleanup_resources(-1, client_socket);
+        return NULL;
+    }
 
-    setvbuf(stdout, NULL, _IONBF, 0);
+    int disconnected = handle_client_input(room, client_socket, &reader);
+    stream_reader_free(&reader);
+    if (disconnected) {
+        // Hráč vypadol uprostred hry - miestnosť ostane pozastavená a čaká na jeho návrat
+        room_park(room);
+        cleanup_resources(-1, client_socket);
+        return NULL;
+    }
 
-    game = malloc(sizeof(Game));
-    if (!game) {
-        perror("malloc failed");
-        exit(EXIT_FAILURE);
+    // Pre záverečné skóre treba hru odloženú v snapshote načítať späť
+    sem_wait(room->sem_game_update);
+    if (room->suspended) {
+        room_restore(room);
     }
+    if (room->game) {
+        int length = snprintf(buffer, BUFFER_SIZE, " Hra skončila! Zjedeného ovocia: %d",
+                              room->game->fruits_eaten);
+        outbound_message(&room->outbound, MSG_END, 0, 0, buffer, length);
+    }
+    sem_post(room->sem_game_update);
+    outbound_drain(&room->outbound); // Do frontu už nikto iný nezapisuje
 
-    sem_unlink("/game_update");
+    int room_id = room->id;
+    room_destroy(room);
+    cleanup_resources(-1, client_socket);
+    LOG_INFO("Miestnosť %d uvoľnená.", room_id);
+    return NULL;
+}
 
-    sem_game_update = sem_open("/game_update", O_CREAT | O_EXCL, 0644, 1);
-    if (sem_game_update == SEM_FAILED) {
-        perror("sem_open failed");
-        free(game);
-        exit(EXIT_FAILURE);
+// Spustí vlákno pre nové (alebo odovzdané) spojenie.
+static void start_client_thread(int client_socket, const char *initial, size_t initial_length) {
+    ClientConnection *connection = malloc(sizeof(ClientConnection));
+    if (!connection || initial_length > sizeof(connection->initial)) {
+        LOG_ERROR("Failed to allocate client connection.");
+        free(connection);
+        cleanup_resources(-1, client_socket);
+        return;
+    }
+    connection->socket = client_socket;
+    connection->initial_length = initial_length;
+    if (initial_length > 0) {
+        memcpy(connection->initial, initial, initial_length);
     }
-    printf("Semaphore initialized successfully.\n");
 
-    sem_post(sem_game_update);
+    pthread_t connection_thread;
+    if (pthread_create(&connection_thread, NULL, client_thread, connection) != 0) {
+        LOG_ERROR("Failed to create client thread.");
+        free(connection);
+        cleanup_resources(-1, client_socket);
+        return;
+    }
+    pthread_detach(connection_thread);
+}
 
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
-        perror("Socket creation failed");
-        cleanup_resources(-1, -1);
-        exit(EXIT_FAILURE);
+static volatile sig_atomic_t server_running = 1;
+
+// SIGINT/SIGTERM ukončí hlavnú slučku, aby sa stihli vypísať logy a trasovanie
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    server_running = 0;
+}
+
+// Hlavná slučka jedného servera (alebo workera v režime supervízora).
+static int serve(void) {
+    int server_fd, client_socket;
+    struct sockaddr_in address;
+    int addrlen = sizeof(address);
+
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        LOG_ERROR("Socket creation failed: %s", strerror(errno));
+        return EXIT_FAILURE;
     }
 
     int opt = 1;
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        perror("setsockopt failed");
+        LOG_ERROR("setsockopt failed: %s", strerror(errno));
         cleanup_resources(server_fd, -1);
-        exit(EXIT_FAILURE);
+        return EXIT_FAILURE;
+    }
+    // Workery zdieľajú port, jadro medzi ne rozdeľuje nové spojenia
+    if (worker_index >= 0 && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        LOG_ERROR("setsockopt SO_REUSEPORT failed: %s", strerror(errno));
+        cleanup_resources(server_fd, -1);
+        return EXIT_FAILURE;
     }
 
     address.sin_family = AF_INET;
@@ -183,96 +718,143 @@ int main() {
     address.sin_port = htons(PORT);
 
     if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
-        perror("Bind failed");
+        LOG_ERROR("Bind failed: %s", strerror(errno));
         cleanup_resources(server_fd, -1);
-        exit(EXIT_FAILURE);
+        return EXIT_FAILURE;
     }
 
-    if (listen(server_fd, 1) < 0) {
-        perror("Listen failed");
+    if (listen(server_fd, SOMAXCONN) < 0) {
+        LOG_ERROR("Listen failed: %s", strerror(errno));
         cleanup_resources(server_fd, -1);
-        exit(EXIT_FAILURE);
+        return EXIT_FAILURE;
     }
 
-    printf("Server is listening on port %d\n", PORT);
+    LOG_INFO("Server is listening on port %d", PORT);
 
-    if ((client_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t *)&addrlen)) < 0) {
-        perror("Accept failed");
+    // Ťahy, časové limity aj ochranné lehoty všetkých miestností plánuje jedno vlákno
+    if (scheduler_start() < 0) {
         cleanup_resources(server_fd, -1);
-        exit(EXIT_FAILURE);
+        return EXIT_FAILURE;
     }
 
-    printf("Client connected\n");
+    // Voliteľný UDP prenos; každý worker má vlastný port, aby datagramy prišli vlastníkovi miestnosti
+    udp_transport_start(worker_index >= 0 ? PORT + 1 + worker_index : PORT);
+    int handoff_fd = worker_index >= 0 ? worker_handoff_open() : -1;
 
-    int bytes_read = read(client_socket, buffer, BUFFER_SIZE);
-    if (bytes_read > 0) {
-        int width, height, game_mode, time_limit, world_type;
-        sscanf(buffer, "%d %d %d %d %d", &width, &height, &game_mode, &time_limit, &world_type);
-        initialize_game(game, width, height, game_mode, time_limit, world_type);
-        printf("Game initialized: Width=%d, Height=%d, Mode=%d, Time Limit=%d, World Type=%d\n",
-               width, height, game_mode, time_limit, world_type);
-    } else {
-        printf("Failed to receive game settings from client.\n");
-    }
-
-    pthread_t game_thread;
-    if (pthread_create(&game_thread, NULL, game_update_thread, &client_socket) != 0) {
-        perror("Failed to create game update thread");
-        cleanup_resources(server_fd, client_socket);
-        exit(EXIT_FAILURE);
-    }
+    while (server_running) {
+        // Čakanie na spojenie s časovým limitom, aby slučka zachytila signál ukončenia
+        struct pollfd pfds[2] = {{server_fd, POLLIN, 0}, {handoff_fd, POLLIN, 0}};
+        int ready = poll(pfds, handoff_fd >= 0 ? 2 : 1, 1000);
+        TRACE_POLL();
+        if (ready <= 0) {
+            continue;
+        }
 
-    printf("Game update thread created successfully.\n");
-
-    while (game->snake.alive) {
-        bytes_read = read(client_socket, buffer, BUFFER_SIZE);
-        if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            printf("Received from client: %s\n", buffer);
-
-            if (strcmp(buffer, "pause") == 0) {
-                sem_wait(sem_game_update);
-                game->player_status.paused = 1;
-                sem_post(sem_game_update);
-            } else if (strcmp(buffer, "quit") == 0) {
-                sem_wait(sem_game_update);
-                game->player_status.active = 0;
-                sem_post(sem_game_update);
-                break;
-            }  else if (strcmp(buffer, "resume") == 0) {
-                sem_wait(sem_game_update);
-                game->player_status.paused = 0;
-                sem_post(sem_game_update);
-                printf("Čakanie 3 sekundy pred obnovením hry...\n");
-                sleep(3);
-            }else {
-                int new_direction = atoi(buffer);
-                sem_wait(sem_game_update);
-                change_direction(&game->snake, new_direction);
-                sem_post(sem_game_update);
+        if (handoff_fd >= 0 && (pfds[1].revents & POLLIN)) {
+            // Spojenie s resume tokenom tejto miestnosti, ktoré prijal iný worker
+            char initial[BUFFER_SIZE];
+            int length = worker_handoff_receive(handoff_fd, &client_socket, initial, sizeof(initial));
+            if (length >= 0) {
+                LOG_INFO("Client handed over by another worker");
+                start_client_thread(client_socket, initial, (size_t)length);
             }
-        } else if (bytes_read == 0) {
-            printf("Client disconnected.\n");
-            break;
-        } else {
-            perror("Error reading from client");
-            break;
         }
 
-        snprintf(buffer, BUFFER_SIZE, "Had: (%d, %d), Ovocie: (%d, %d) - Status hry: %s",
-                 game->snake.body[0].x, game->snake.body[0].y,
-                 game->fruit.x, game->fruit.y,
-                 game->snake.alive ? "Živý" : "Hra skončila");
-        send(client_socket, buffer, strlen(buffer), 0);
+        if (!(pfds[0].revents & POLLIN)) {
+            continue;
+        }
+        if ((client_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t *)&addrlen)) < 0) {
+            LOG_ERROR("Accept failed: %s", strerror(errno));
+            continue;
+        }
+
+        LOG_INFO("Client connected");
+        METRIC_ADD(connections, 1);
+        start_client_thread(client_socket, NULL, 0);
     }
 
-    snprintf(buffer, BUFFER_SIZE, " Hra skončila! Zjedeného ovocia: %d", game->snake.length - 1);
-    send(client_socket, buffer, strlen(buffer), 0);
+    scheduler_stop();
 
-    pthread_join(game_thread, NULL);
+#ifdef SNAKE_TRACE
+    // Pri ukončení servera sa trasovanie vypíše vždy
+    const char *trace_path = getenv("SNAKE_TRACE_FILE");
+    trace_dump(trace_path ? trace_path : TRACE_DEFAULT_FILE);
+#endif
 
-    cleanup_resources(server_fd, client_socket);
+    if (handoff_fd >= 0) close(handoff_fd);
+    cleanup_resources(server_fd, -1);
+    rooms_cleanup_process(getpid()); // Rozohrané hry končia so serverom
 
-    printf("Server shutdown.\n");
+    LOG_INFO("Server shutdown.");
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char *argv[]) {
+    int workers = 0; // 0 = jeden proces bez supervízora
+    int verify = 0;
+    int verify_framing = 0;
+    uint32_t verify_seed = (uint32_t)time(NULL);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify-engine") == 0) {
+            verify = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                verify_seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+            }
+        } else if (strcmp(argv[i], "--verify-protocol") == 0) {
+            verify_framing = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--workers N] [--verify-engine [seed]] [--verify-protocol]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Výpisy idú cez asynchrónny logger, herné vlákna tak nikdy nečakajú na terminál
+    if (log_init(LOG_LEVEL_INFO) < 0) {
+        perror("Failed to start log writer");
+        exit(EXIT_FAILURE);
+    }
+    if (verify_framing) {
+        // Iba overí rámcovanie správ a skončí
+        const char *difference = verify_protocol();
+        if (difference) {
+            LOG_ERROR("verify-protocol: %s.", difference);
+        } else {
+            LOG_INFO("verify-protocol: rámec s %d bajtmi prešiel čítačom, limit max_size platí.",
+                     VERIFY_PROTOCOL_PAYLOAD);
+        }
+        log_shutdown();
+        return difference ? EXIT_FAILURE : 0;
+    }
+    if (verify) {
+        // Iba overí engine a skončí, server sa nespúšťa
+        int result = verify_engine(verify_seed);
+        log_shutdown();
+        return result == 0 ? 0 : EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN); // Odpojený klient nesmie zhodiť celý server
+    trace_install_signal_handler();
+
+    struct sigaction stop_action = {0};
+    stop_action.sa_handler = handle_stop_signal;
+    sigemptyset(&stop_action.sa_mask);
+    sigaction(SIGINT, &stop_action, NULL);
+    sigaction(SIGTERM, &stop_action, NULL);
+
+    const char *snapshot_dir = getenv("SNAKE_SNAPSHOT_DIR");
+    rooms_init(snapshot_dir ? snapshot_dir : SNAPSHOT_DIR);
+
+    if (workers <= 0) {
+        int result = serve();
+        log_shutdown();
+        return result;
+    }
+
+    LOG_INFO("Supervisor: spúšťam %d workerov na porte %d.", workers, PORT);
+    int result = run_supervisor(workers, serve, &server_running);
+    LOG_INFO("Supervisor shutdown.");
+    log_shutdown();
+    return result == 0 ? 0 : EXIT_FAILURE;
+}
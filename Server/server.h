@@ -1,20 +1,30 @@
 #ifndef SERVER_H
 #define SERVER_H
 
-#include <semaphore.h>
 #include "../Game_logic/game_logic.h"
+#include "../Game_logic/game_render.h"
+#include "interest.h"
+#include "room.h"
 
 // Makrá
 #define PORT 45544
 #define BUFFER_SIZE 1024
-
-// Globálne premenné
-extern Game *game;
-extern sem_t *sem_game_update;
+#define CLIENT_READER_MAX_SIZE 4096 // Najviac bajtov neukončeného príkazu od klienta, potom sa odpojí
+#define TICK_INTERVAL_MS 2000     // Interval medzi ťahmi hry
+#define RESUME_COUNTDOWN_MS 3000  // Odpočet pred obnovením pohybu po pauze
+#define SNAPSHOT_DIR "/tmp" // Predvolený adresár pre snapshoty pozastavených hier
+#define MIN_WORLD_SIZE 5     // Najmenší povolený rozmer mapy (ovocie potrebuje vnútorné políčka)
+#define MAX_WORLD_SIZE 256   // Najväčší povolený rozmer mapy
+#define VIEWPORT_MIN_SIZE 3          // Najmenší výrez mapy pri malom termináli
+#define VIEWPORT_MINIMAP_WIDTH 16    // Rozmer minimapy pod výrezom
+#define VIEWPORT_MINIMAP_HEIGHT 6
 
 // Funkcie
-void draw_game_to_buffer(const Game *game, char *buffer);
-void *game_update_thread(void *arg);
+// Rozmer výrezu mapy pre terminál columns x rows (0 = neznámy terminál, celá mapa).
+void viewport_size(const Game *game, int columns, int rows, int *view_width, int *view_height);
+// Vykreslí oblasť záujmu view, pod ňou polohu výrezu a minimapu sveta.
+// Ak oblasť pokrýva celú mapu, je to rámec draw_game_to_buffer.
+int draw_viewport_to_buffer(const Game *game, const InterestArea *view, char *buffer, size_t size);
 void cleanup_resources(int server_fd, int client_socket);
 
 #endif // SERVER_H
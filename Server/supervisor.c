@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "log.h"
+#include "room.h"
+#include "supervisor.h"
+
+WorkerMetrics *worker_metrics = NULL;
+int worker_index = -1;
+
+static pid_t supervisor_pid = 0;
+
+static long long supervisor_monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Spustí worker index. V potomkovi sa už nevracia.
+static pid_t spawn_worker(WorkerMetrics *metrics, int index, int (*worker_main)(void)) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        LOG_ERROR("fork failed: %s", strerror(errno));
+        return -1;
+    }
+    if (pid == 0) {
+        worker_index = index;
+        worker_metrics = &metrics[index];
+        char tag[16];
+        snprintf(tag, sizeof(tag), "w%d", index);
+        log_after_fork(tag);
+        int code = worker_main();
+        log_shutdown();
+        exit(code);
+    }
+
+    atomic_store(&metrics[index].pid, (int)pid);
+    LOG_INFO("Worker %d spustený (pid %d).", index, (int)pid);
+    return pid;
+}
+
+static void log_metrics(const WorkerMetrics *metrics, int workers) {
+    int alive = 0, rooms = 0;
+    unsigned int connections = 0, handoffs = 0, restarts = 0, slow = 0;
+    unsigned long long frames = 0, replaced = 0;
+    for (int i = 0; i < workers; i++) {
+        alive += atomic_load(&metrics[i].pid) > 0;
+        rooms += atomic_load(&metrics[i].active_rooms);
+        connections += atomic_load(&metrics[i].connections);
+        handoffs += atomic_load(&metrics[i].handoffs);
+        restarts += atomic_load(&metrics[i].restarts);
+        frames += atomic_load(&metrics[i].frames_sent);
+        replaced += atomic_load(&metrics[i].frames_replaced);
+        slow += atomic_load(&metrics[i].slow_disconnects);
+    }
+    LOG_INFO("Workery: %d/%d bežia, spojenia=%u, miestnosti=%d, rámce=%llu (nahradené %llu), "
+             "odovzdania=%u, reštarty=%u, pomalí klienti=%u",
+             alive, workers, connections, rooms, frames, replaced, handoffs, restarts, slow);
+}
+
+int run_supervisor(int workers, int (*worker_main)(void), volatile sig_atomic_t *running) {
+    if (workers < 1 || workers > MAX_WORKERS) {
+        LOG_ERROR("Počet workerov musí byť 1 až %d.", MAX_WORKERS);
+        return -1;
+    }
+
+    // Anonymná zdieľaná pamäť prežije fork, workery do nej zapisujú a supervízor z nej číta
+    WorkerMetrics *metrics = mmap(NULL, sizeof(WorkerMetrics) * MAX_WORKERS, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (metrics == MAP_FAILED) {
+        LOG_ERROR("mmap failed: %s", strerror(errno));
+        return -1;
+    }
+
+    supervisor_pid = getpid();
+    long long restart_at[MAX_WORKERS] = {0}; // 0 = worker beží alebo reštart nie je naplánovaný
+    for (int i = 0; i < workers; i++) {
+        if (spawn_worker(metrics, i, worker_main) < 0) {
+            restart_at[i] = supervisor_monotonic_ms() + WORKER_RESTART_DELAY_MS;
+        }
+    }
+
+    long long next_metrics_ms = supervisor_monotonic_ms() + SUPERVISOR_METRICS_INTERVAL_SECONDS * 1000;
+    while (*running) {
+        struct timespec interval = {0, 100 * 1000000L};
+        nanosleep(&interval, NULL);
+
+        int status;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            for (int i = 0; i < workers; i++) {
+                if (atomic_load(&metrics[i].pid) != (int)pid) continue;
+                atomic_store(&metrics[i].pid, 0);
+                atomic_store(&metrics[i].active_rooms, 0);
+                rooms_cleanup_process(pid); // Semafory a snapshoty spadnutého workera
+                if (WIFSIGNALED(status)) {
+                    LOG_ERROR("Worker %d (pid %d) spadol na signál %d.", i, (int)pid, WTERMSIG(status));
+                } else {
+                    LOG_WARN("Worker %d (pid %d) skončil s kódom %d.", i, (int)pid, WEXITSTATUS(status));
+                }
+                if (*running) {
+                    restart_at[i] = supervisor_monotonic_ms() + WORKER_RESTART_DELAY_MS;
+                }
+            }
+        }
+
+        long long now_ms = supervisor_monotonic_ms();
+        for (int i = 0; i < workers && *running; i++) {
+            if (restart_at[i] != 0 && now_ms >= restart_at[i]) {
+                atomic_fetch_add(&metrics[i].restarts, 1);
+                restart_at[i] = spawn_worker(metrics, i, worker_main) < 0
+                    ? now_ms + WORKER_RESTART_DELAY_MS : 0;
+            }
+        }
+
+        if (now_ms >= next_metrics_ms) {
+            log_metrics(metrics, workers);
+            next_metrics_ms = now_ms + SUPERVISOR_METRICS_INTERVAL_SECONDS * 1000;
+        }
+    }
+
+    for (int i = 0; i < workers; i++) {
+        pid_t pid = (pid_t)atomic_load(&metrics[i].pid);
+        if (pid > 0) kill(pid, SIGTERM);
+    }
+    for (int i = 0; i < workers; i++) {
+        pid_t pid = (pid_t)atomic_load(&metrics[i].pid);
+        if (pid > 0) {
+            waitpid(pid, NULL, 0);
+            atomic_store(&metrics[i].pid, 0);
+        }
+    }
+    log_metrics(metrics, workers);
+    munmap(metrics, sizeof(WorkerMetrics) * MAX_WORKERS);
+    return 0;
+}
+
+int token_owner(const char *token) {
+    unsigned int owner;
+    if (sscanf(token, "%2x", &owner) != 1 || owner >= MAX_WORKERS) return -1;
+    return (int)owner;
+}
+
+// Adresa v abstraktnom mennom priestore, platí len počas behu supervízora
+static socklen_t handoff_address(int index, struct sockaddr_un *address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    int length = snprintf(address->sun_path + 1, sizeof(address->sun_path) - 1, "snake_worker_%d_%d",
+                          (int)supervisor_pid, index);
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + length);
+}
+
+int worker_handoff_open(void) {
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un address;
+    socklen_t length = handoff_address(worker_index, &address);
+    if (bind(fd, (struct sockaddr *)&address, length) < 0) {
+        LOG_WARN("Worker %d: handoff socket bind failed: %s", worker_index, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int worker_handoff_send(int owner, int client_socket, const char *data, size_t length) {
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un address;
+    socklen_t address_length = handoff_address(owner, &address);
+
+    // Socket klienta ide ako SCM_RIGHTS, už prečítané bajty ako obsah správy
+    struct iovec part = {(void *)data, length};
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr message = {0};
+    message.msg_name = &address;
+    message.msg_namelen = address_length;
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &client_socket, sizeof(int));
+
+    ssize_t sent = sendmsg(fd, &message, 0);
+    close(fd);
+    return sent == (ssize_t)length ? 0 : -1;
+}
+
+int worker_handoff_receive(int handoff_fd, int *client_socket, char *data, size_t cap) {
+    struct iovec part = {data, cap};
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr message = {0};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+
+    ssize_t received = recvmsg(handoff_fd, &message, MSG_CMSG_CLOEXEC);
+    if (received < 0) return -1;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) return -1;
+    memcpy(client_socket, CMSG_DATA(cmsg), sizeof(int));
+    return (int)received;
+}
@@ -0,0 +1,55 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <signal.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+// Režim supervízora (server --workers N): hlavný proces spustí N workerov, ktoré zdieľajú
+// port cez SO_REUSEPORT a každý má vlastné miestnosti a pamäť. Supervízor z metrík
+// v zdieľanej pamäti vypisuje súhrn a spadnutého workera spustí znova.
+
+#define MAX_WORKERS 64
+#define SUPERVISOR_METRICS_INTERVAL_SECONDS 10 // Ako často supervízor vypisuje súhrn metrík
+#define WORKER_RESTART_DELAY_MS 500            // Pauza pred reštartom spadnutého workera
+
+// Počítadlá jedného workera v pamäti zdieľanej so supervízorom.
+typedef struct {
+    atomic_int pid;
+    atomic_uint restarts;          // Koľkokrát supervízor worker reštartoval
+    atomic_uint connections;       // Prijaté TCP spojenia
+    atomic_int active_rooms;       // Práve obsadené miestnosti
+    atomic_ullong frames_sent;     // Odoslané rámce (TCP, UDP aj zdieľaná pamäť)
+    atomic_uint handoffs;          // Spojenia odovzdané workerovi, ktorý vlastní miestnosť
+    atomic_ullong frames_replaced; // Rámce nahradené novším, kým ich pomalý klient neprijal
+    atomic_uint slow_disconnects;  // Klienti odpojení, lebo neprijímali dáta
+} WorkerMetrics;
+
+// Metriky tohto workera, alebo NULL, ak server beží ako jeden proces.
+extern WorkerMetrics *worker_metrics;
+
+// Index tohto workera, alebo -1, ak server beží ako jeden proces.
+extern int worker_index;
+
+#define METRIC_ADD(field, n) \
+    do { \
+        if (worker_metrics) atomic_fetch_add_explicit(&worker_metrics->field, (n), memory_order_relaxed); \
+    } while (0)
+
+// Spustí workers procesov s funkciou worker_main a dohliada na ne, kým *running nie je 0.
+// Potom workerom pošle SIGTERM a počká na ne. Vráti 0 pri úspechu.
+int run_supervisor(int workers, int (*worker_main)(void), volatile sig_atomic_t *running);
+
+// Vráti index workera, ktorý vydal resume token, alebo -1, ak ho nemožno určiť.
+int token_owner(const char *token);
+
+// Otvorí socket, cez ktorý tento worker prijíma spojenia odovzdané inými workermi.
+int worker_handoff_open(void);
+
+// Odovzdá spojenie (aj už prečítané bajty) workerovi owner. Vráti 0 pri úspechu.
+int worker_handoff_send(int owner, int client_socket, const char *data, size_t length);
+
+// Prijme odovzdané spojenie. Vráti počet prečítaných bajtov alebo -1 pri chybe.
+int worker_handoff_receive(int handoff_fd, int *client_socket, char *data, size_t cap);
+
+#endif // SUPERVISOR_H
@@ -0,0 +1,137 @@
+#include "timer_wheel.h"
+#include <string.h>
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now_ms = now_ms;
+}
+
+void timer_init(Timer *timer, TimerCallback callback, void *context) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires_ms = 0;
+    timer->callback = callback;
+    timer->context = context;
+}
+
+static void timer_unlink(Timer *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Zaradí časovač do slotu podľa vzdialenosti od aktuálneho času kolesa.
+static void timer_wheel_insert(TimerWheel *wheel, Timer *timer) {
+    if (timer->expires_ms < wheel->now_ms) {
+        timer->expires_ms = wheel->now_ms;
+    }
+    uint64_t delta = timer->expires_ms - wheel->now_ms;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ull << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    if (delta >= (1ull << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))) {
+        // Dlhšie oneskorenie, než pokrýva koleso, sa skráti na jeho maximum
+        timer->expires_ms = wheel->now_ms + (1ull << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    }
+
+    Timer **slot = &wheel->slots[level][(timer->expires_ms >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+    timer->next = *slot;
+    if (*slot) {
+        (*slot)->pprev = &timer->next;
+    }
+    *slot = timer;
+    timer->pprev = slot;
+}
+
+void timer_wheel_add(TimerWheel *wheel, Timer *timer, uint64_t expires_ms) {
+    if (timer_pending(timer)) {
+        timer_unlink(timer);
+        wheel->pending--;
+    }
+    timer->expires_ms = expires_ms;
+    timer_wheel_insert(wheel, timer);
+    wheel->pending++;
+}
+
+void timer_wheel_remove(TimerWheel *wheel, Timer *timer) {
+    if (timer_pending(timer)) {
+        timer_unlink(timer);
+        wheel->pending--;
+    }
+}
+
+// Presunie časovače slotu vyššej úrovne, do ktorého bloku koleso práve vstúpilo.
+static void timer_wheel_cascade(TimerWheel *wheel, int level) {
+    size_t index = (wheel->now_ms >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    Timer *timer = wheel->slots[level][index];
+    wheel->slots[level][index] = NULL;
+    while (timer) {
+        Timer *next = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        timer_wheel_insert(wheel, timer);
+        timer = next;
+    }
+}
+
+Timer *timer_wheel_expire(TimerWheel *wheel, uint64_t now_ms) {
+    if (wheel->pending == 0) {
+        // Prázdne koleso netreba prechádzať po milisekundách
+        if (now_ms > wheel->now_ms) wheel->now_ms = now_ms;
+        return NULL;
+    }
+    while (1) {
+        Timer *timer = wheel->slots[0][wheel->now_ms & TIMER_WHEEL_MASK];
+        if (timer) {
+            timer_unlink(timer);
+            wheel->pending--;
+            return timer;
+        }
+        if (wheel->now_ms >= now_ms) {
+            return NULL;
+        }
+
+        wheel->now_ms++;
+        // Na začiatku bloku úrovne L sa najprv kaskádujú vyššie úrovne
+        int levels = 0;
+        while (levels < TIMER_WHEEL_LEVELS - 1
+               && ((wheel->now_ms >> (TIMER_WHEEL_BITS * levels)) & TIMER_WHEEL_MASK) == 0) {
+            levels++;
+        }
+        for (int level = levels; level >= 1; level--) {
+            timer_wheel_cascade(wheel, level);
+        }
+    }
+}
+
+uint64_t timer_wheel_next_expiry(const TimerWheel *wheel) {
+    if (wheel->pending == 0) return UINT64_MAX;
+
+    // Úroveň 0 obsahuje len časovače najbližších 256 ms, ich čas je presný
+    for (size_t offset = 0; offset < TIMER_WHEEL_SLOTS; offset++) {
+        if (wheel->slots[0][(wheel->now_ms + offset) & TIMER_WHEEL_MASK]) {
+            return wheel->now_ms + offset;
+        }
+    }
+
+    // Pre vyššie úrovne stačí začiatok bloku, v ktorom sa časovače presunú nižšie
+    uint64_t earliest = UINT64_MAX;
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        int shift = TIMER_WHEEL_BITS * level;
+        uint64_t block = wheel->now_ms >> shift;
+        for (uint64_t offset = 1; offset <= TIMER_WHEEL_SLOTS; offset++) {
+            if (wheel->slots[level][(block + offset) & TIMER_WHEEL_MASK]) {
+                uint64_t start = (block + offset) << shift;
+                if (start < earliest) earliest = start;
+                break;
+            }
+        }
+    }
+    return earliest;
+}
@@ -0,0 +1,54 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchické časové koleso s rozlíšením 1 ms. Každá úroveň má TIMER_WHEEL_SLOTS slotov,
+// slot úrovne L pokrýva 256^L ms. Vloženie aj zrušenie časovača je O(1), časovače
+// vzdialených úrovní sa pri prechode do ich bloku presunú (kaskádujú) o úroveň nižšie.
+
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4 // Rozsah 2^32 ms (približne 49 dní)
+
+typedef struct Timer Timer;
+
+typedef void (*TimerCallback)(void *context);
+
+// Časovač je vložený priamo v objekte, ktorý plánuje (miestnosť), nič sa nealokuje.
+struct Timer {
+    Timer *next;
+    Timer **pprev;        // Adresa ukazovateľa, ktorý ukazuje na tento časovač (NULL = nenaplánovaný)
+    uint64_t expires_ms;
+    TimerCallback callback;
+    void *context;
+};
+
+typedef struct {
+    uint64_t now_ms;      // Čas, po ktorý je koleso spracované
+    size_t pending;       // Počet naplánovaných časovačov
+    Timer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms);
+
+void timer_init(Timer *timer, TimerCallback callback, void *context);
+
+static inline int timer_pending(const Timer *timer) {
+    return timer->pprev != NULL;
+}
+
+// Naplánuje časovač na čas expires_ms (už naplánovaný sa presunie).
+void timer_wheel_add(TimerWheel *wheel, Timer *timer, uint64_t expires_ms);
+
+// Zruší časovač, ak je naplánovaný.
+void timer_wheel_remove(TimerWheel *wheel, Timer *timer);
+
+// Posúva koleso k času now_ms a vráti ďalší vypršaný časovač (už vyradený), alebo NULL.
+Timer *timer_wheel_expire(TimerWheel *wheel, uint64_t now_ms);
+
+// Dolný odhad najbližšieho vypršania (UINT64_MAX, ak nie je nič naplánované).
+uint64_t timer_wheel_next_expiry(const TimerWheel *wheel);
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include "../Protocol/protocol.h"
+#include "log.h"
+#include "udp_transport.h"
+
+static int udp_socket = -1;
+static int udp_port = -1;
+
+typedef struct {
+    struct sockaddr_in from;
+    unsigned int seqs[UDP_INPUT_REDUNDANCY];
+    int directions[UDP_INPUT_REDUNDANCY];
+    unsigned long long times[UDP_INPUT_REDUNDANCY];
+    int count;
+} UdpInputs;
+
+// Zapamätá si adresu klienta a použije vstupy, ktoré server ešte nevidel (od najstaršieho).
+static void apply_udp_inputs(Room *room, void *context) {
+    UdpInputs *inputs = context;
+
+    sem_wait(room->sem_game_update);
+    if (room->use_udp) {
+        room->udp_addr = inputs->from;
+        room->udp_addr_known = 1;
+        for (int i = 0; i < inputs->count; i++) {
+            if (room->suspended || inputs->seqs[i] <= room->last_input_seq) continue;
+            room_apply_input(room, inputs->seqs[i], inputs->directions[i], inputs->times[i]);
+        }
+    }
+    sem_post(room->sem_game_update);
+}
+
+static void *udp_receive_thread(void *arg) {
+    (void)arg;
+    char datagram[UDP_MAX_DATAGRAM + 1];
+
+    while (1) {
+        UdpInputs inputs = {0};
+        socklen_t from_length = sizeof(inputs.from);
+        ssize_t received = recvfrom(udp_socket, datagram, UDP_MAX_DATAGRAM, 0,
+                                    (struct sockaddr *)&inputs.from, &from_length);
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("UDP recvfrom failed: %s", strerror(errno));
+            break;
+        }
+        datagram[received] = '\0';
+
+        // "HELLO <token>" len ohlási adresu, "IN <token> <seq> <smer> <čas> ..." nesie aj vstupy
+        char token[RESUME_TOKEN_LENGTH + 1];
+        int offset = 0;
+        if (sscanf(datagram, "HELLO %32s%n", token, &offset) != 1
+            && sscanf(datagram, "IN %32s%n", token, &offset) != 1) {
+            LOG_DEBUG("Neplatný UDP paket.");
+            continue;
+        }
+        if (strncmp(datagram, "IN ", 3) == 0) {
+            const char *cursor = datagram + offset;
+            int consumed;
+            while (inputs.count < UDP_INPUT_REDUNDANCY
+                   && sscanf(cursor, "%u %d %llu%n", &inputs.seqs[inputs.count],
+                             &inputs.directions[inputs.count], &inputs.times[inputs.count], &consumed) == 3) {
+                inputs.count++;
+                cursor += consumed;
+            }
+        }
+
+        if (!room_with_token(token, apply_udp_inputs, &inputs)) {
+            LOG_DEBUG("UDP paket pre neznámu miestnosť.");
+        }
+    }
+    return NULL;
+}
+
+int udp_transport_start(int port) {
+    udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_socket < 0) {
+        LOG_WARN("UDP socket creation failed: %s", strerror(errno));
+        return -1;
+    }
+
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    if (bind(udp_socket, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        LOG_WARN("UDP bind failed: %s", strerror(errno));
+        close(udp_socket);
+        udp_socket = -1;
+        return -1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, udp_receive_thread, NULL) != 0) {
+        LOG_WARN("Failed to create UDP receive thread.");
+        close(udp_socket);
+        udp_socket = -1;
+        return -1;
+    }
+    pthread_detach(thread);
+
+    udp_port = port;
+    LOG_INFO("UDP transport is listening on port %d", port);
+    return 0;
+}
+
+int udp_transport_port(void) {
+    return udp_port;
+}
+
+int udp_send_delta(Room *room, const FrameTiming *timing, const char *keyframe, unsigned int keyframe_tick,
+                   const char *frame, int frame_length) {
+    if (udp_socket < 0 || !room->udp_addr_known) return -1;
+
+    char datagram[UDP_MAX_DATAGRAM];
+    int length = build_frame_delta(datagram, sizeof(datagram), room->tick, keyframe_tick,
+                                   room->last_input_seq, timing, keyframe, frame, frame_length,
+                                   room->view.width, room->view.height);
+    if (length < 0) return -1;
+
+    // Strata datagramu nevadí - ďalší rozdiel je tiež voči keyframe, nie voči tomuto rámcu
+    sendto(udp_socket, datagram, (size_t)length, MSG_DONTWAIT,
+           (struct sockaddr *)&room->udp_addr, sizeof(room->udp_addr));
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef UDP_TRANSPORT_H
+#define UDP_TRANSPORT_H
+
+#include "room.h"
+
+// Otvorí UDP socket na danom porte a spustí vlákno prijímajúce vstupy klientov.
+// Vráti 0 pri úspechu; pri chybe server ďalej funguje len cez TCP.
+int udp_transport_start(int port);
+
+// Port UDP prenosu alebo -1, ak UDP nie je k dispozícii.
+int udp_transport_port(void);
+
+// Pošle klientovi rozdiel rámca voči keyframe. Volá sa pod sem_game_update.
+// Vráti -1, ak sa rozdiel nedá poslať (treba poslať keyframe cez TCP).
+int udp_send_delta(Room *room, const FrameTiming *timing, const char *keyframe, unsigned int keyframe_tick,
+                   const char *frame, int frame_length);
+
+#endif // UDP_TRANSPORT_H
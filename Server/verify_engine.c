@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../Game_logic/game_logic.h"
+#include "../Game_logic/game_hash.h"
+#include "../Game_logic/game_items.h"
+#include "../Game_logic/game_reference.h"
+#include "../Game_logic/game_snapshot.h"
+#include "../Game_logic/snake_batch.h"
+#include "log.h"
+#include "server.h"
+#include "verify_engine.h"
+
+// Dvojica hier, ktoré musia ostať zhodné: referenčná a optimalizovaná.
+typedef struct {
+    Game reference;
+    Game engine;
+} EnginePair;
+
+// Generátor samotného overenia (voľba ťahov a rozmerov), nezávislý od generátorov hier.
+static uint32_t verify_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Obe hry začnú z rovnakého semena. Vráti -1 pri chybe alokácie.
+static int pair_start(EnginePair *pair, int width, int height, int world_type, int fruit_target, uint32_t seed) {
+    initialize_game_seeded(&pair->reference, width, height, STANDARD, 0, world_type, seed);
+    initialize_game_seeded(&pair->engine, width, height, STANDARD, 0, world_type, seed);
+    if (!pair->reference.obstacles || !pair->engine.obstacles) return -1;
+    pair->reference.fruit_target = pair->engine.fruit_target = fruit_target;
+    return 0;
+}
+
+static void pair_release(EnginePair *pair) {
+    release_game(&pair->reference);
+    release_game(&pair->engine);
+}
+
+// Porovná stav hada a ovocia. Vráti popis prvého rozdielu alebo NULL.
+static const char *compare_snakes(const Game *expected, const Game *actual) {
+    if (expected->snake.alive != actual->snake.alive) return "alive";
+    if (expected->snake.length != actual->snake.length) return "length";
+    if (expected->snake.direction != actual->snake.direction) return "direction";
+    if (memcmp(expected->snake.body, actual->snake.body, (size_t)expected->snake.length * sizeof(Point)) != 0) {
+        return "body";
+    }
+    return NULL;
+}
+
+static const char *compare_games(const Game *expected, const Game *actual) {
+    const char *difference = compare_snakes(expected, actual);
+    if (difference) return difference;
+    for (int cell = 0; cell < expected->width * expected->height; cell++) {
+        if ((expected->cells[cell] & CELL_ITEM_MASK) != (actual->cells[cell] & CELL_ITEM_MASK)) return "items";
+    }
+    for (int item = ITEM_FRUIT; item < ITEM_TYPES; item++) {
+        if (expected->item_counts[item] != actual->item_counts[item]) return "item_counts";
+    }
+    if (expected->fruits_eaten != actual->fruits_eaten) return "fruits_eaten";
+    if (expected->speed_ticks != actual->speed_ticks) return "speed_ticks";
+    if (expected->rng_state != actual->rng_state) return "rng_state";
+    return NULL;
+}
+
+// Porovná mapu vykreslenú referenčne s mapou z draw_game_to_buffer (súhrn obsahuje čas, ten sa vynechá).
+static const char *compare_frames(const Game *expected, const Game *actual, char *reference_frame,
+                                  char *frame, size_t size) {
+    int map_length = reference_draw_map(expected, reference_frame, size);
+    int length = draw_game_to_buffer(actual, frame, size);
+    if (map_length < 0 || length < map_length) return "frame length";
+    return memcmp(reference_frame, frame, (size_t)map_length) == 0 ? NULL : "frame";
+}
+
+// Prenesie hru cez snapshot a porovná obnovenú hru s referenciou.
+static const char *check_snapshot(const Game *expected, const Game *actual, char *reference_frame,
+                                  char *frame, size_t size) {
+    size_t snapshot_size = game_snapshot_size(actual);
+    void *snapshot = malloc(snapshot_size);
+    if (!snapshot) return "snapshot malloc";
+
+    const char *difference = NULL;
+    Game restored;
+    if (game_snapshot_write(actual, snapshot, snapshot_size) == 0
+        || game_snapshot_restore(&restored, snapshot, snapshot_size) < 0) {
+        difference = "snapshot";
+    } else {
+        difference = compare_games(expected, &restored);
+        if (!difference && game_hash(&restored) != game_hash(actual)) difference = "snapshot hash";
+        if (!difference) difference = compare_frames(expected, &restored, reference_frame, frame, size);
+        release_game(&restored);
+    }
+    free(snapshot);
+    return difference;
+}
+
+// Jedno kolo: count hier rovnakého rozmeru bežiacich vo všetkých troch engine naraz.
+static int verify_round(uint32_t *state, int round) {
+    int width = 5 + (int)(verify_rand(state) % 36);
+    int height = 5 + (int)(verify_rand(state) % 21);
+    int world_type = (int)(verify_rand(state) % 2);
+    int count = 1 + (int)(verify_rand(state) % VERIFY_ENGINE_MAX_GAMES);
+    int fruit_target = 1 + (int)(verify_rand(state) % 8) * (int)(verify_rand(state) % 8);
+
+    EnginePair *pairs = calloc((size_t)count, sizeof(EnginePair));
+    SnakeBatch *batch = snake_batch_create(count, width, height, world_type);
+    uint8_t *results = malloc((size_t)count);
+    size_t frame_size = (size_t)(width + 1) * (size_t)height + 128;
+    char *reference_frame = malloc(frame_size);
+    char *frame = malloc(frame_size);
+    int started = 0, failed = 0;
+    if (!pairs || !batch || !results || !reference_frame || !frame) {
+        LOG_ERROR("verify-engine: malloc failed.");
+        failed = 1;
+    }
+
+    for (int i = 0; !failed && i < count; i++, started++) {
+        if (pair_start(&pairs[i], width, height, world_type, fruit_target, verify_rand(state) | 1) < 0) {
+            LOG_ERROR("verify-engine: malloc failed.");
+            failed = 1;
+        } else {
+            snake_batch_load(batch, i, &pairs[i].engine);
+        }
+    }
+
+    long games = count, items = 0;
+    for (int tick = 0; !failed && tick < VERIFY_ENGINE_TICKS; tick++) {
+        for (int i = 0; i < count; i++) {
+            uint32_t choice = verify_rand(state) % 6; // 4 a 5 = hráč nestlačil nič
+            if (choice < 4) {
+                reference_change_direction(&pairs[i].reference.snake, (int)choice);
+                change_direction(&pairs[i].engine.snake, (int)choice);
+                snake_batch_change_direction(batch, i, (int)choice);
+            }
+        }
+        snake_batch_step(batch, results);
+
+        for (int i = 0; !failed && i < count; i++) {
+            Game *reference = &pairs[i].reference;
+            Game *engine = &pairs[i].engine;
+            int expected = reference_move_snake(reference);
+            int moved = move_snake(engine);
+            const char *difference = NULL;
+            if (moved != expected) difference = "move_snake result";
+            else if (results[i] != expected) difference = "snake_batch_step result";
+
+            // Zber predmetov ako v room_tick, dávka len zopakuje zmenu dĺžky
+            if (!difference && expected) {
+                int length = engine->snake.length;
+                int item = reference_collect_item(reference);
+                if (game_collect_item(engine) != item) difference = "collected item";
+                if (engine->snake.length > length) snake_batch_grow(batch, i);
+                if (engine->snake.length < length) snake_batch_shrink(batch, i, length - engine->snake.length);
+                items += item != ITEM_NONE;
+            }
+
+            if (!difference) difference = compare_games(reference, engine);
+            if (!difference && engine->board_hash != game_board_hash_compute(engine)) difference = "board_hash";
+            if (!difference) difference = compare_frames(reference, engine, reference_frame, frame, frame_size);
+            if (!difference) {
+                Game batched = *engine; // Prekážky a ovocie zdieľa, hada prepíše dávka
+                snake_batch_store(batch, i, &batched);
+                difference = compare_snakes(reference, &batched);
+                if (!difference) difference = compare_frames(reference, &batched, reference_frame, frame, frame_size);
+                if (difference == NULL && tick % VERIFY_ENGINE_SNAPSHOT_INTERVAL == 0) {
+                    difference = check_snapshot(reference, engine, reference_frame, frame, frame_size);
+                }
+            }
+
+            if (difference) {
+                LOG_ERROR("verify-engine: kolo %d (%dx%d, svet %d), hra %d, ťah %d: líši sa %s.",
+                          round, width, height, world_type, i, tick, difference);
+                failed = 1;
+            } else if (!reference->snake.alive) {
+                // Skončená hra sa nahradí novou s ďalším semenom
+                pair_release(&pairs[i]);
+                if (pair_start(&pairs[i], width, height, world_type, fruit_target, verify_rand(state) | 1) < 0) {
+                    LOG_ERROR("verify-engine: malloc failed.");
+                    failed = 1;
+                } else {
+                    snake_batch_load(batch, i, &pairs[i].engine);
+                    games++;
+                }
+            }
+        }
+    }
+
+    if (!failed) {
+        LOG_INFO("verify-engine: kolo %d (%dx%d, svet %d, %d ovocí): %ld hier, %ld predmetov, %d ťahov, bez rozdielov.",
+                 round, width, height, world_type, fruit_target, games, items, VERIFY_ENGINE_TICKS);
+    }
+    for (int i = 0; i < started; i++) {
+        pair_release(&pairs[i]);
+    }
+    free(pairs);
+    snake_batch_free(batch);
+    free(results);
+    free(reference_frame);
+    free(frame);
+    return failed ? -1 : 0;
+}
+
+int verify_engine(uint32_t seed) {
+    uint32_t state = seed ? seed : 1;
+    LOG_INFO("verify-engine: semeno %u, %d kôl po %d ťahov.", seed, VERIFY_ENGINE_ROUNDS, VERIFY_ENGINE_TICKS);
+    for (int round = 0; round < VERIFY_ENGINE_ROUNDS; round++) {
+        if (verify_round(&state, round) < 0) {
+            LOG_ERROR("verify-engine: engine sa NEZHODUJÚ (semeno %u).", seed);
+            return -1;
+        }
+    }
+    LOG_INFO("verify-engine: všetky engine sa zhodujú.");
+    return 0;
+}
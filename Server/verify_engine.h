@@ -0,0 +1,19 @@
+#ifndef VERIFY_ENGINE_H
+#define VERIFY_ENGINE_H
+
+#include <stdint.h>
+
+// Rozdielové overenie hernej logiky (server --verify-engine [seed]): náhodné hry s daným
+// semenom bežia naraz v referenčnom engine (game_reference), v game_logic aj v SnakeBatch
+// a po každom ťahu sa porovná stav hada, ovocie, generátor aj vykreslená mapa.
+// Pravidelne sa overí aj prechod cez snapshot.
+
+#define VERIFY_ENGINE_ROUNDS 24          // Počet kôl (každé má vlastný rozmer a typ sveta)
+#define VERIFY_ENGINE_TICKS 1500         // Počet ťahov v jednom kole
+#define VERIFY_ENGINE_MAX_GAMES 48       // Najviac hier naraz v jednom kole
+#define VERIFY_ENGINE_SNAPSHOT_INTERVAL 97 // Po koľkých ťahoch sa hra prenesie cez snapshot
+
+// Spustí overenie. Vráti 0, ak sa všetky engine zhodovali, inak -1 (prvý rozdiel sa zaloguje).
+int verify_engine(uint32_t seed);
+
+#endif // VERIFY_ENGINE_H
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../Game_logic/game_hash.h"
+#include "../Game_logic/game_items.h"
+#include "bots.h"
+
+static const int step_x[4] = {0, 1, 0, -1};
+static const int step_y[4] = {-1, 0, 1, 0};
+
+static uint32_t bot_rand(BotContext *context) {
+    uint32_t x = context->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    context->rng_state = x;
+    return x;
+}
+
+// Políčko, na ktoré by hlava prišla smerom direction (podľa pravidiel move_snake).
+// Vráti 0, ak by had vyšiel z mapy so stenami.
+static inline int bot_next_cell(const Game *game, Point from, int direction, Point *cell) {
+    Point next = {from.x + step_x[direction], from.y + step_y[direction]};
+    if (next.x < 0 || next.x >= game->width || next.y < 0 || next.y >= game->height) {
+        if (game->world_type != WORLD_NO_OBSTACLES) return 0;
+        next.x = (next.x + game->width) % game->width;
+        next.y = (next.y + game->height) % game->height;
+    }
+    *cell = next;
+    return 1;
+}
+
+// Prežije had ťah na políčko? Chvost sa v tom ťahu posunie, takže nezavadzia.
+static int bot_cell_safe(const Game *game, Point cell) {
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[cell.y][cell.x] == 1) return 0;
+    for (int i = 0; i < game->snake.length - 1; i++) {
+        if (points_equal(game->snake.body[i], cell)) return 0;
+    }
+    return 1;
+}
+
+// Smer, ktorý change_direction prijme (otočenie o 180 stupňov sa ignoruje).
+static int bot_direction_allowed(const Game *game, int direction) {
+    return (game->snake.direction + 2) % 4 != direction;
+}
+
+// Vzdialenosť po mriežke (vo svete bez prekážok cez okraj).
+static int bot_distance(const Game *game, Point a, Point b) {
+    int dx = abs(a.x - b.x);
+    int dy = abs(a.y - b.y);
+    if (game->world_type == WORLD_NO_OBSTACLES) {
+        if (game->width - dx < dx) dx = game->width - dx;
+        if (game->height - dy < dy) dy = game->height - dy;
+    }
+    return dx + dy;
+}
+
+// Náhodný povolený smer bez ohľadu na bezpečnosť (spodná hranica pre porovnanie).
+static int bot_random(const Game *game, BotContext *context) {
+    int direction;
+    do {
+        direction = (int)(bot_rand(context) % 4);
+    } while (!bot_direction_allowed(game, direction));
+    return direction;
+}
+
+// Bezpečný ťah najbližšie k najbližšiemu ovociu (vzdušnou čiarou), remízy náhodne.
+static int bot_greedy(const Game *game, BotContext *context) {
+    Point head = game->snake.body[0];
+    Point target = head;
+    int target_distance = -1;
+    for (int y = 0; y < game->height; y++) {
+        for (int x = 0; x < game->width; x++) {
+            if (game_item_at(game, x, y) != ITEM_FRUIT) continue;
+            int distance = bot_distance(game, head, (Point){x, y});
+            if (target_distance < 0 || distance < target_distance) {
+                target = (Point){x, y};
+                target_distance = distance;
+            }
+        }
+    }
+
+    int best = BOT_KEEP_DIRECTION, best_distance = 0, ties = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        Point cell;
+        if (!bot_direction_allowed(game, direction) || !bot_next_cell(game, head, direction, &cell) ||
+            !bot_cell_safe(game, cell)) {
+            continue;
+        }
+        int distance = bot_distance(game, cell, target);
+        if (best == BOT_KEEP_DIRECTION || distance < best_distance) {
+            best = direction;
+            best_distance = distance;
+            ties = 1;
+        } else if (distance == best_distance && bot_rand(context) % ++ties == 0) {
+            best = direction;
+        }
+    }
+    return best;
+}
+
+// Prehľadá do šírky voľné políčka od start. Vráti ich počet, v *fruit_distance je počet
+// krokov k najbližšiemu ovociu (-1, ak nie je dosiahnuteľné). Prehľadávanie skončí, keď
+// našlo ovocie aj miesto pre celé telo, vtedy je počet len dolná hranica.
+static int bot_flood(const Game *game, BotContext *context, Point start, int *fruit_distance) {
+    uint32_t mark = ++context->seen_mark;
+    if (mark == 0) {
+        // Pretečenie značky: staré značky by sa mohli zhodovať
+        memset(context->seen, 0, sizeof(uint32_t) * (size_t)game->width * game->height);
+        mark = context->seen_mark = 1;
+    }
+    for (int i = 0; i < game->snake.length - 1; i++) {
+        Point body = game->snake.body[i];
+        context->seen[body.y * game->width + body.x] = mark;
+    }
+
+    int head = 0, tail = 0, level_end = 1, distance = 0;
+    *fruit_distance = -1;
+    context->queue[tail++] = start.y * game->width + start.x;
+    context->seen[start.y * game->width + start.x] = mark;
+    while (head < tail) {
+        if (head == level_end) {
+            distance++;
+            level_end = tail;
+        }
+        int index = context->queue[head++];
+        Point cell = {index % game->width, index / game->width};
+        if (*fruit_distance < 0 && game_item_at(game, cell.x, cell.y) == ITEM_FRUIT) {
+            *fruit_distance = distance;
+        }
+        if (*fruit_distance >= 0 && tail >= game->snake.length) break;
+        for (int direction = 0; direction < 4; direction++) {
+            Point next;
+            if (!bot_next_cell(game, cell, direction, &next)) continue;
+            int next_index = next.y * game->width + next.x;
+            if (context->seen[next_index] == mark) continue;
+            if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[next.y][next.x] == 1) continue;
+            context->seen[next_index] = mark;
+            context->queue[tail++] = next_index;
+        }
+    }
+    return tail;
+}
+
+// Najkratšia cesta k ovociu cez ťahy, po ktorých ostane dosť miesta pre celé telo;
+// ak taký ťah nie je, ťah do najväčšieho voľného priestoru.
+static int bot_flood_fill(const Game *game, BotContext *context) {
+    // Rozhodnutie závisí len od mapy, hlavy, chvosta (ten prehľadávanie nepovažuje za prekážku)
+    // a smeru, čo všetko game_hash pokrýva; pre zopakovaný stav sa prehľadávanie preskočí
+    uint64_t hash = game_hash(game);
+    BotCacheEntry *entry = &context->cache[hash & (BOT_CACHE_SIZE - 1)];
+    if (entry->hash == hash) {
+        context->cache_hits++;
+        return entry->direction;
+    }
+    context->cache_misses++;
+
+    Point head = game->snake.body[0];
+    int best = BOT_KEEP_DIRECTION, best_roomy = 0, best_distance = 0, best_area = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        Point cell;
+        if (!bot_direction_allowed(game, direction) || !bot_next_cell(game, head, direction, &cell) ||
+            !bot_cell_safe(game, cell)) {
+            continue;
+        }
+        int distance;
+        int area = bot_flood(game, context, cell, &distance);
+        int roomy = area >= game->snake.length;
+        if (distance < 0) distance = game->width * game->height; // Ovocie za telom: neskôr sa uvoľní
+
+        int better;
+        if (best == BOT_KEEP_DIRECTION || roomy != best_roomy) {
+            better = best == BOT_KEEP_DIRECTION || roomy;
+        } else if (roomy) {
+            better = distance < best_distance || (distance == best_distance && area > best_area);
+        } else {
+            better = area > best_area;
+        }
+        if (better) {
+            best = direction;
+            best_roomy = roomy;
+            best_distance = distance;
+            best_area = area;
+        }
+    }
+    entry->hash = hash;
+    entry->direction = best;
+    return best;
+}
+
+const BotController bot_controllers[] = {
+    {"random", "náhodný povolený smer", bot_random},
+    {"greedy", "bezpečný ťah najbližšie k ovociu", bot_greedy},
+    {"flood", "najkratšia cesta k ovociu s dostatkom miesta pre telo", bot_flood_fill},
+};
+const int bot_controller_count = sizeof(bot_controllers) / sizeof(bot_controllers[0]);
+
+int bot_context_init(BotContext *context, int width, int height) {
+    size_t cells = (size_t)width * height;
+    context->rng_state = 1;
+    context->queue = malloc(cells * sizeof(int));
+    context->seen = calloc(cells, sizeof(uint32_t));
+    context->seen_mark = 0;
+    context->cache = calloc(BOT_CACHE_SIZE, sizeof(BotCacheEntry));
+    context->cache_hits = context->cache_misses = 0;
+    if (!context->queue || !context->seen || !context->cache) {
+        bot_context_free(context);
+        return -1;
+    }
+    return 0;
+}
+
+void bot_context_free(BotContext *context) {
+    free(context->queue);
+    free(context->seen);
+    free(context->cache);
+    context->queue = NULL;
+    context->seen = NULL;
+    context->cache = NULL;
+}
+
+const BotController *bot_find(const char *name) {
+    for (int i = 0; i < bot_controller_count; i++) {
+        if (strcmp(bot_controllers[i].name, name) == 0) return &bot_controllers[i];
+    }
+    return NULL;
+}
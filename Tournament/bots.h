@@ -0,0 +1,48 @@
+#ifndef BOTS_H
+#define BOTS_H
+
+#include <stdint.h>
+#include "../Game_logic/game_logic.h"
+
+// Ovládače hada pre turnaj. Bot dostane stav hry pred ťahom a vráti smer 0 - 3 (ako
+// change_direction) alebo BOT_KEEP_DIRECTION. Nový bot je jedna funkcia a riadok v bot_controllers.
+
+#define BOT_KEEP_DIRECTION -1
+#define BOT_CACHE_SIZE 4096 // Záznamy cache rozhodnutí deterministických botov (mocnina dvoch)
+
+// Rozhodnutie bota pre stav s daným game_hash (hash 0 = prázdny záznam).
+typedef struct {
+    uint64_t hash;
+    int direction;
+} BotCacheEntry;
+
+// Pracovný stav bota, patrí vláknu turnaja (nič sa počas ťahu nealokuje).
+typedef struct {
+    uint32_t rng_state;  // Generátor bota, nezávislý od generátora hry (bot nemení rozloženie ovocia)
+    int *queue;          // [width * height] fronta prehľadávania do šírky
+    uint32_t *seen;      // [width * height] políčko je navštívené, ak seen == seen_mark
+    uint32_t seen_mark;  // Zvýši sa pred každým prehľadávaním, takže seen netreba nulovať
+    BotCacheEntry *cache; // [BOT_CACHE_SIZE] priamo mapovaná cache podľa game_hash; platí pre hry
+                          // jedného rozmeru a bota bez náhody, ktorý vidí telo len ako prekážky
+                          // okrem chvosta (krúžiaci had sa do rovnakého stavu vracia)
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+} BotContext;
+
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*choose)(const Game *game, BotContext *context);
+} BotController;
+
+extern const BotController bot_controllers[];
+extern const int bot_controller_count;
+
+// Pripraví pracovný stav pre hry rozmeru width x height. Vráti -1 pri chybe alokácie.
+int bot_context_init(BotContext *context, int width, int height);
+void bot_context_free(BotContext *context);
+
+// Nájde bota podľa mena. Vráti NULL, ak taký nie je.
+const BotController *bot_find(const char *name);
+
+#endif // BOTS_H
@@ -0,0 +1,459 @@
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../Game_logic/game_hash.h"
+#include "../Game_logic/game_items.h"
+#include "../Game_logic/game_logic.h"
+#include "tournament.h"
+#include "work_deque.h"
+
+// Stav jedného vlákna turnaja. Štatistiky a výsledky zapisuje len vlastník, ostatné vlákna
+// siahajú iba na jeho deque (krádež), takže v hernej slučke nie je žiadny zdieľaný zápis.
+typedef struct {
+    WorkDeque deque;
+    int index;
+    pthread_t thread;
+    const TournamentConfig *config;
+    atomic_uint *tasks_left;    // Spoločný počet neodohraných úloh (mení sa raz za rozsah)
+    struct TournamentWorkerList *all;
+    uint32_t rng_state;         // Voľba vlákna, od ktorého sa kradne
+    void *grid;                 // Mriežky hry, použijú sa pre každú hru znova
+    BotContext bot;
+    BotStats stats[TOURNAMENT_MAX_BOTS];
+    GameRecord *records;        // Len pri výstupe do CSV
+    size_t record_count;
+    size_t record_capacity;
+    uint64_t records_lost;
+    uint64_t steals;
+} TournamentWorker;
+
+typedef struct TournamentWorkerList {
+    TournamentWorker *workers;
+    int count;
+} TournamentWorkerList;
+
+uint32_t tournament_game_seed(uint32_t seed, uint32_t game) {
+    // Miešanie (murmur3 fmix32), aby susedné hry nemali podobné semená
+    uint32_t x = seed + game * 0x9e3779b9u;
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x ? x : 1;
+}
+
+// Príčina smrti pri ťahu, ktorý move_snake práve odmietol (hlava sa počíta pred ťahom).
+static TournamentEnd tournament_death_cause(const Game *game, Point head) {
+    static const int step_x[4] = {0, 1, 0, -1};
+    static const int step_y[4] = {-1, 0, 1, 0};
+    Point next = {head.x + step_x[game->snake.direction], head.y + step_y[game->snake.direction]};
+    if (next.x < 0 || next.x >= game->width || next.y < 0 || next.y >= game->height) {
+        if (game->world_type != WORLD_NO_OBSTACLES) return TOURNAMENT_END_WALL;
+        next.x = (next.x + game->width) % game->width;
+        next.y = (next.y + game->height) % game->height;
+    }
+    if (game->world_type == WORLD_WITH_OBSTACLES && game->obstacles[next.y][next.x] == 1) {
+        return TOURNAMENT_END_OBSTACLE;
+    }
+    return TOURNAMENT_END_SELF;
+}
+
+void tournament_play(const TournamentConfig *config, uint32_t task, void *grid, BotContext *context,
+                     GameRecord *record) {
+    uint32_t game_index = task / (uint32_t)config->bot_count;
+    const BotController *bot = config->bots[task % (uint32_t)config->bot_count];
+    uint32_t seed = tournament_game_seed(config->seed, game_index);
+
+    Game game;
+    initialize_game_in(&game, grid, config->width, config->height, STANDARD, 0, config->world_type, seed);
+    game.fruit_target = config->fruits;
+    context->rng_state = (seed ^ 0x2545f491u) | 1;
+
+    int starve_limit = config->width * config->height * TOURNAMENT_STARVE_FACTOR;
+    int ticks = 0, last_fruit_tick = 0;
+    TournamentEnd end = TOURNAMENT_END_TICK_LIMIT;
+    while (ticks < config->max_ticks) {
+        int direction = bot->choose(&game, context);
+        if (direction != BOT_KEEP_DIRECTION) {
+            change_direction(&game.snake, direction);
+        }
+
+        Point head = game.snake.body[0];
+        ticks++;
+        if (!move_snake(&game)) {
+            end = tournament_death_cause(&game, head);
+            break;
+        }
+        int eaten = game.fruits_eaten;
+        game_collect_item(&game);
+        if (game.fruits_eaten != eaten) {
+            last_fruit_tick = ticks;
+        } else if (ticks - last_fruit_tick >= starve_limit) {
+            end = TOURNAMENT_END_STARVED;
+            break;
+        }
+    }
+
+    record->task = task;
+    record->seed = seed;
+    record->score = game.fruits_eaten;
+    record->length = game.snake.length;
+    record->ticks = ticks;
+    record->end = end;
+    record->hash = game_hash(&game);
+}
+
+static int tick_bucket(int ticks) {
+    int bucket = 0;
+    while (ticks > 1 && bucket < TOURNAMENT_TICK_BUCKETS - 1) {
+        ticks >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void stats_add(BotStats *stats, const GameRecord *record) {
+    stats->games++;
+    stats->ticks += (uint64_t)record->ticks;
+    stats->score_sum += (uint64_t)record->score;
+    if (record->score > stats->score_max) stats->score_max = record->score;
+    if (record->ticks > stats->ticks_max) stats->ticks_max = record->ticks;
+    stats->scores[record->score < TOURNAMENT_SCORE_BUCKETS ? record->score : TOURNAMENT_SCORE_BUCKETS - 1]++;
+    stats->tick_buckets[tick_bucket(record->ticks)]++;
+    stats->endings[record->end]++;
+}
+
+static void stats_merge(BotStats *into, const BotStats *from) {
+    into->games += from->games;
+    into->ticks += from->ticks;
+    into->score_sum += from->score_sum;
+    if (from->score_max > into->score_max) into->score_max = from->score_max;
+    if (from->ticks_max > into->ticks_max) into->ticks_max = from->ticks_max;
+    for (int i = 0; i < TOURNAMENT_SCORE_BUCKETS; i++) into->scores[i] += from->scores[i];
+    for (int i = 0; i < TOURNAMENT_TICK_BUCKETS; i++) into->tick_buckets[i] += from->tick_buckets[i];
+    for (int i = 0; i < TOURNAMENT_END_REASONS; i++) into->endings[i] += from->endings[i];
+}
+
+// Index koša, v ktorom leží daný percentil.
+static int bucket_percentile(const uint64_t *buckets, int count, uint64_t total, int percent) {
+    uint64_t rank = (total * (uint64_t)percent + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < count; i++) {
+        seen += buckets[i];
+        if (seen >= rank && seen > 0) return i;
+    }
+    return count - 1;
+}
+
+static int worker_store(TournamentWorker *worker, const GameRecord *record) {
+    if (worker->record_count == worker->record_capacity) {
+        size_t capacity = worker->record_capacity ? worker->record_capacity * 2 : 1024;
+        GameRecord *grown = realloc(worker->records, capacity * sizeof(GameRecord));
+        if (!grown) return -1;
+        worker->records = grown;
+        worker->record_capacity = capacity;
+    }
+    worker->records[worker->record_count++] = *record;
+    return 0;
+}
+
+static void worker_run_range(TournamentWorker *worker, WorkRange range) {
+    // Horná polovica ide späť do deque, kde si ju môže ukradnúť nečinné vlákno
+    while (range.end - range.begin > TOURNAMENT_GRAIN) {
+        uint32_t middle = range.begin + (range.end - range.begin) / 2;
+        if (work_deque_push(&worker->deque, (WorkRange){middle, range.end}) < 0) break;
+        range.end = middle;
+    }
+
+    for (uint32_t task = range.begin; task < range.end; task++) {
+        GameRecord record;
+        tournament_play(worker->config, task, worker->grid, &worker->bot, &record);
+        stats_add(&worker->stats[task % (uint32_t)worker->config->bot_count], &record);
+        if (worker->config->csv_path && worker_store(worker, &record) < 0) {
+            worker->records_lost++; // Súhrn ostáva úplný, chýba len riadok v CSV
+        }
+    }
+    atomic_fetch_sub_explicit(worker->tasks_left, range.end - range.begin, memory_order_relaxed);
+}
+
+// Skúsi ukradnúť rozsah od ostatných vlákien (začína náhodným vláknom). Vráti 1 pri úspechu.
+static int worker_steal(TournamentWorker *worker, WorkRange *range) {
+    TournamentWorkerList *all = worker->all;
+    worker->rng_state ^= worker->rng_state << 13;
+    worker->rng_state ^= worker->rng_state >> 17;
+    worker->rng_state ^= worker->rng_state << 5;
+    int start = (int)(worker->rng_state % (uint32_t)all->count);
+    for (int i = 0; i < all->count; i++) {
+        TournamentWorker *victim = &all->workers[(start + i) % all->count];
+        if (victim == worker) continue;
+        int status;
+        while ((status = work_deque_steal(&victim->deque, range)) < 0) {
+        }
+        if (status == 1) {
+            worker->steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *worker_thread(void *arg) {
+    TournamentWorker *worker = arg;
+    WorkRange range;
+    for (;;) {
+        if (work_deque_take(&worker->deque, &range) || worker_steal(worker, &range)) {
+            worker_run_range(worker, range);
+        } else if (atomic_load_explicit(worker->tasks_left, memory_order_relaxed) == 0) {
+            break;
+        } else {
+            sched_yield(); // Posledné rozsahy dohrávajú iné vlákna
+        }
+    }
+    return NULL;
+}
+
+static int compare_records(const void *a, const void *b) {
+    uint32_t left = ((const GameRecord *)a)->task, right = ((const GameRecord *)b)->task;
+    return (left > right) - (left < right);
+}
+
+static const char *const end_names[TOURNAMENT_END_REASONS] = {"stena", "prekážka", "telo", "hlad", "limit"};
+
+// Zlúči výsledky vlákien a zapíše ich do CSV v poradí úloh.
+static int write_csv(const TournamentConfig *config, const TournamentWorkerList *all) {
+    size_t total = 0;
+    for (int i = 0; i < all->count; i++) total += all->workers[i].record_count;
+    GameRecord *records = malloc((total ? total : 1) * sizeof(GameRecord));
+    if (!records) return -1;
+    size_t offset = 0;
+    for (int i = 0; i < all->count; i++) {
+        memcpy(records + offset, all->workers[i].records, all->workers[i].record_count * sizeof(GameRecord));
+        offset += all->workers[i].record_count;
+    }
+    qsort(records, total, sizeof(GameRecord), compare_records);
+
+    FILE *file = fopen(config->csv_path, "w");
+    if (!file) {
+        free(records);
+        return -1;
+    }
+    fprintf(file, "game,seed,bot,score,length,ticks,end,hash\n");
+    for (size_t i = 0; i < total; i++) {
+        const GameRecord *record = &records[i];
+        fprintf(file, "%u,%u,%s,%d,%d,%d,%s,%016llx\n", record->task / (uint32_t)config->bot_count, record->seed,
+                config->bots[record->task % (uint32_t)config->bot_count]->name, record->score, record->length,
+                record->ticks, end_names[record->end], (unsigned long long)record->hash);
+    }
+    free(records);
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+void tournament_report(const TournamentConfig *config, const BotStats *stats, double seconds, FILE *out) {
+    uint64_t games = 0, ticks = 0;
+    fprintf(out, "%-8s %7s %7s %4s %4s %4s %8s %6s %6s", "bot", "hry", "skóre", "p50", "p90", "max",
+            "ťahy", "p50<", "max");
+    for (int end = 0; end < TOURNAMENT_END_REASONS; end++) fprintf(out, " %8s", end_names[end]);
+    fprintf(out, "\n");
+
+    for (int bot = 0; bot < config->bot_count; bot++) {
+        const BotStats *s = &stats[bot];
+        if (s->games == 0) continue;
+        games += s->games;
+        ticks += s->ticks;
+        fprintf(out, "%-8s %7llu %7.2f %4d %4d %4d %8.1f %6d %6d", config->bots[bot]->name,
+                (unsigned long long)s->games, (double)s->score_sum / s->games,
+                bucket_percentile(s->scores, TOURNAMENT_SCORE_BUCKETS, s->games, 50),
+                bucket_percentile(s->scores, TOURNAMENT_SCORE_BUCKETS, s->games, 90), s->score_max,
+                (double)s->ticks / s->games,
+                2 << bucket_percentile(s->tick_buckets, TOURNAMENT_TICK_BUCKETS, s->games, 50), s->ticks_max);
+        for (int end = 0; end < TOURNAMENT_END_REASONS; end++) {
+            fprintf(out, " %7.1f%%", 100.0 * (double)s->endings[end] / s->games);
+        }
+        fprintf(out, "\n");
+    }
+    fprintf(out, "%llu hier, %llu ťahov za %.2f s (%.0f hier/s, %.0f ťahov/s)\n", (unsigned long long)games,
+            (unsigned long long)ticks, seconds, seconds > 0 ? games / seconds : 0.0,
+            seconds > 0 ? ticks / seconds : 0.0);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [--games N] [--threads N] [--bots meno,meno] [--size ŠxV] [--world 0|1]\n"
+                    "          [--fruits N] [--max-ticks N] [--seed N] [--csv súbor]\n", program);
+    fprintf(stderr, "Boti:\n");
+    for (int i = 0; i < bot_controller_count; i++) {
+        fprintf(stderr, "  %-8s %s\n", bot_controllers[i].name, bot_controllers[i].description);
+    }
+}
+
+// Rozdelí zoznam mien botov oddelený čiarkami. Vráti -1 pri neznámom mene.
+static int parse_bots(TournamentConfig *config, const char *list) {
+    char names[256];
+    snprintf(names, sizeof(names), "%s", list);
+    config->bot_count = 0;
+    for (char *save = NULL, *name = strtok_r(names, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+        const BotController *bot = bot_find(name);
+        if (!bot || config->bot_count == TOURNAMENT_MAX_BOTS) {
+            fprintf(stderr, "Neznámy bot alebo priveľa botov: %s\n", name);
+            return -1;
+        }
+        config->bots[config->bot_count++] = bot;
+    }
+    return config->bot_count > 0 ? 0 : -1;
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    TournamentConfig config = {
+        .games = TOURNAMENT_DEFAULT_GAMES,
+        .threads = (int)sysconf(_SC_NPROCESSORS_ONLN),
+        .width = TOURNAMENT_DEFAULT_WIDTH,
+        .height = TOURNAMENT_DEFAULT_HEIGHT,
+        .world_type = WORLD_WITH_OBSTACLES,
+        .fruits = 1,
+        .max_ticks = TOURNAMENT_DEFAULT_MAX_TICKS,
+        .seed = (uint32_t)time(NULL),
+    };
+    const char *bots = "greedy";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            config.games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc) {
+            bots = argv[++i];
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &config.width, &config.height) != 2) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc) {
+            config.world_type = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fruits") == 0 && i + 1 < argc) {
+            config.fruits = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+            config.max_ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            config.csv_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (parse_bots(&config, bots) < 0 || config.games <= 0 || config.width < 3 || config.height < 3 ||
+        config.fruits < 1 || config.fruits > MAX_FRUITS || config.max_ticks <= 0 ||
+        (uint64_t)config.games * config.bot_count > UINT32_MAX / 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (config.world_type != WORLD_WITH_OBSTACLES) config.world_type = WORLD_NO_OBSTACLES;
+    uint32_t tasks = (uint32_t)config.games * (uint32_t)config.bot_count;
+    if (config.threads < 1) config.threads = 1;
+    if ((uint32_t)config.threads > tasks) config.threads = (int)tasks;
+
+    // Vlákna sú zarovnané na riadky cache, aby sa ich štatistiky a deque neprekrývali
+    TournamentWorkerList all = {aligned_alloc(WORK_DEQUE_ALIGN, (size_t)config.threads * sizeof(TournamentWorker)),
+                                config.threads};
+    if (!all.workers) {
+        perror("aligned_alloc failed");
+        return EXIT_FAILURE;
+    }
+    memset(all.workers, 0, (size_t)config.threads * sizeof(TournamentWorker));
+    atomic_uint tasks_left;
+    atomic_init(&tasks_left, tasks);
+
+    int failed = 0;
+    for (int i = 0; i < config.threads; i++) {
+        TournamentWorker *worker = &all.workers[i];
+        worker->index = i;
+        worker->config = &config;
+        worker->tasks_left = &tasks_left;
+        worker->all = &all;
+        worker->rng_state = tournament_game_seed(config.seed, (uint32_t)i) | 1;
+        worker->grid = malloc(game_grid_size(config.width, config.height));
+        if (!worker->grid || bot_context_init(&worker->bot, config.width, config.height) < 0) failed = 1;
+
+        // Každé vlákno začína so súvislým rozsahom, zvyšok práce sa rozdelí kradnutím
+        work_deque_init(&worker->deque);
+        uint32_t begin = (uint32_t)((uint64_t)tasks * i / config.threads);
+        uint32_t end = (uint32_t)((uint64_t)tasks * (i + 1) / config.threads);
+        work_deque_push(&worker->deque, (WorkRange){begin, end});
+    }
+    if (failed) {
+        perror("malloc failed");
+        return EXIT_FAILURE;
+    }
+
+    printf("Turnaj: %d hier x %d botov, svet %dx%d (typ %d, %d ovocí), %d vlákien, semeno %u\n",
+           config.games, config.bot_count, config.width, config.height, config.world_type, config.fruits,
+           config.threads, config.seed);
+    fflush(stdout);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (int i = 1; i < config.threads; i++) {
+        int error = pthread_create(&all.workers[i].thread, NULL, worker_thread, &all.workers[i]);
+        if (error != 0) {
+            // Úlohy nespusteného vlákna si ukradnú ostatné
+            fprintf(stderr, "pthread_create failed: %s\n", strerror(error));
+            break;
+        }
+        started = i;
+    }
+    worker_thread(&all.workers[0]); // Hlavné vlákno hrá tiež
+    for (int i = 1; i <= started; i++) {
+        pthread_join(all.workers[i].thread, NULL);
+    }
+    double seconds = elapsed_seconds(&start);
+
+    // Zlúčenie bufferov vlákien až po skončení všetkých hier
+    static BotStats stats[TOURNAMENT_MAX_BOTS];
+    uint64_t steals = 0, records_lost = 0, cache_hits = 0, cache_lookups = 0;
+    for (int i = 0; i < config.threads; i++) {
+        for (int bot = 0; bot < config.bot_count; bot++) {
+            stats_merge(&stats[bot], &all.workers[i].stats[bot]);
+        }
+        steals += all.workers[i].steals;
+        records_lost += all.workers[i].records_lost;
+        cache_hits += all.workers[i].bot.cache_hits;
+        cache_lookups += all.workers[i].bot.cache_hits + all.workers[i].bot.cache_misses;
+    }
+    tournament_report(&config, stats, seconds, stdout);
+    printf("Ukradnutých rozsahov: %llu\n", (unsigned long long)steals);
+    if (cache_lookups > 0) {
+        printf("Cache rozhodnutí botov: %llu z %llu stavov (%.1f%%)\n", (unsigned long long)cache_hits,
+               (unsigned long long)cache_lookups, 100.0 * (double)cache_hits / (double)cache_lookups);
+    }
+
+    int result = EXIT_SUCCESS;
+    if (records_lost > 0) {
+        fprintf(stderr, "V CSV chýba %llu hier (nedostatok pamäte).\n", (unsigned long long)records_lost);
+        result = EXIT_FAILURE;
+    }
+    if (config.csv_path && write_csv(&config, &all) < 0) {
+        fprintf(stderr, "Zápis %s zlyhal: %s\n", config.csv_path, strerror(errno));
+        result = EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < config.threads; i++) {
+        free(all.workers[i].grid);
+        bot_context_free(&all.workers[i].bot);
+        free(all.workers[i].records);
+    }
+    free(all.workers);
+    return result;
+}
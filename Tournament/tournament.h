@@ -0,0 +1,80 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "bots.h"
+
+// Turnaj botov (tournament): tisíce hier bez servera a terminálu, každá so semenom odvodeným
+// od semena turnaja a čísla hry, bežia paralelne na všetkých jadrách. Hra i s botom b je
+// úloha i * bots + b, takže všetci boti hrajú rovnaké svety. Vlákna si úlohy rozdeľujú
+// kradnutím rozsahov (work_deque.h) a výsledky zapisujú len do vlastných bufferov, ktoré sa
+// zlúčia až po skončení. Výsledok nezávisí od počtu vlákien.
+
+#define TOURNAMENT_DEFAULT_GAMES 10000
+#define TOURNAMENT_DEFAULT_WIDTH 30
+#define TOURNAMENT_DEFAULT_HEIGHT 15
+#define TOURNAMENT_DEFAULT_MAX_TICKS 5000 // Najdlhšia hra v ťahoch (čas hry sa v turnaji nemeria)
+#define TOURNAMENT_GRAIN 8              // Menší rozsah úloh sa už nedelí ani nekradne
+#define TOURNAMENT_STARVE_FACTOR 4      // Hra končí po width * height * faktor ťahoch bez ovocia
+#define TOURNAMENT_MAX_BOTS 8
+#define TOURNAMENT_SCORE_BUCKETS 256    // Presný histogram skóre (posledný kôš aj pre vyššie)
+#define TOURNAMENT_TICK_BUCKETS 32      // Histogram dĺžky hry po mocninách dvoch
+
+typedef enum {
+    TOURNAMENT_END_WALL = 0,   // Náraz do okraja sveta s prekážkami
+    TOURNAMENT_END_OBSTACLE,   // Náraz do prekážky
+    TOURNAMENT_END_SELF,       // Náraz do vlastného tela
+    TOURNAMENT_END_STARVED,    // Bot dlho nezjedol ovocie (krúži)
+    TOURNAMENT_END_TICK_LIMIT, // Hra dosiahla max_ticks
+    TOURNAMENT_END_REASONS
+} TournamentEnd;
+
+typedef struct {
+    int games;                // Počet svetov (každý bot odohrá každý)
+    int threads;
+    int width;
+    int height;
+    int world_type;
+    int fruits;               // Počet ovocí na mape naraz (fruit_target)
+    int max_ticks;
+    uint32_t seed;
+    const BotController *bots[TOURNAMENT_MAX_BOTS];
+    int bot_count;
+    const char *csv_path;     // Výsledok každej hry do CSV, NULL = len súhrn
+} TournamentConfig;
+
+// Súhrn hier jedného bota (jedného vlákna alebo po zlúčení celého turnaja).
+typedef struct {
+    uint64_t games;
+    uint64_t ticks;           // Súčet dĺžok hier
+    uint64_t score_sum;
+    int score_max;
+    int ticks_max;
+    uint64_t scores[TOURNAMENT_SCORE_BUCKETS];
+    uint64_t tick_buckets[TOURNAMENT_TICK_BUCKETS];
+    uint64_t endings[TOURNAMENT_END_REASONS];
+} BotStats;
+
+// Výsledok jednej hry (pre CSV).
+typedef struct {
+    uint32_t task;            // game * bot_count + bot
+    uint32_t seed;
+    int score;
+    int length;               // Dĺžka hada na konci
+    int ticks;
+    int end;                  // TournamentEnd
+    uint64_t hash;            // game_hash konečného stavu (zhoda pri opakovaní hry so semenom)
+} GameRecord;
+
+// Semeno hry game v turnaji so semenom seed (rovnaké pre všetkých botov).
+uint32_t tournament_game_seed(uint32_t seed, uint32_t game);
+
+// Odohrá jednu hru. grid má game_grid_size(width, height) bajtov a patrí volajúcemu vláknu.
+void tournament_play(const TournamentConfig *config, uint32_t task, void *grid, BotContext *context,
+                     GameRecord *record);
+
+// Zapíše súhrn turnaja.
+void tournament_report(const TournamentConfig *config, const BotStats *stats, double seconds, FILE *out);
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,68 @@
+#include "work_deque.h"
+
+static inline uint64_t range_pack(WorkRange range) {
+    return (uint64_t)range.begin << 32 | range.end;
+}
+
+static inline WorkRange range_unpack(uint64_t packed) {
+    return (WorkRange){(uint32_t)(packed >> 32), (uint32_t)packed};
+}
+
+void work_deque_init(WorkDeque *deque) {
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    for (int i = 0; i < WORK_DEQUE_CAPACITY; i++) {
+        atomic_init(&deque->tasks[i], 0);
+    }
+}
+
+int work_deque_push(WorkDeque *deque, WorkRange range) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (bottom - top >= WORK_DEQUE_CAPACITY) return -1;
+
+    atomic_store_explicit(&deque->tasks[bottom & (WORK_DEQUE_CAPACITY - 1)], range_pack(range),
+                          memory_order_relaxed);
+    // Zlodej, ktorý uvidí nový spodok, uvidí aj úlohu
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return 0;
+}
+
+int work_deque_take(WorkDeque *deque, WorkRange *range) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    // Zníženie spodku musí byť viditeľné skôr, ako sa prečíta vrch (inak by úlohu vzali dvaja)
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed); // Prázdna
+        return 0;
+    }
+
+    *range = range_unpack(atomic_load_explicit(&deque->tasks[bottom & (WORK_DEQUE_CAPACITY - 1)],
+                                               memory_order_relaxed));
+    if (top < bottom) return 1;
+
+    // Posledná úloha: o ňu sa vlastník pretekne so zlodejmi cez vrch
+    int won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                      memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return won;
+}
+
+int work_deque_steal(WorkDeque *deque, WorkRange *range) {
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) return 0;
+
+    uint64_t packed = atomic_load_explicit(&deque->tasks[top & (WORK_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return -1;
+    }
+    *range = range_unpack(packed);
+    return 1;
+}
@@ -0,0 +1,37 @@
+#ifndef WORK_DEQUE_H
+#define WORK_DEQUE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Deque úloh jedného vlákna na rozdeľovanie práce kradnutím (Chase-Lev): vlastník pridáva
+// a berie zo spodku bez zámkov, ostatné vlákna kradnú zhora jedným CAS. Úlohou je rozsah
+// indexov [begin, end), ktorý vlastník delí na polovice, takže zlodej vždy vezme najväčší kus.
+
+#define WORK_DEQUE_CAPACITY 64 // Mocnina dvoch; delením na polovice je v deque najviac log2(úloh) rozsahov
+#define WORK_DEQUE_ALIGN 64    // Vrch a spodok sú na samostatných riadkoch cache
+
+typedef struct {
+    uint32_t begin;
+    uint32_t end;
+} WorkRange;
+
+typedef struct {
+    _Alignas(WORK_DEQUE_ALIGN) atomic_long top;    // Mení sa pri krádeži (a pri poslednej úlohe)
+    _Alignas(WORK_DEQUE_ALIGN) atomic_long bottom; // Mení len vlastník
+    _Atomic uint64_t tasks[WORK_DEQUE_CAPACITY];   // Rozsah zbalený do jedného slova (begin << 32 | end)
+} WorkDeque;
+
+void work_deque_init(WorkDeque *deque);
+
+// Pridá rozsah na spodok (volá len vlastník). Vráti -1, ak je deque plná.
+int work_deque_push(WorkDeque *deque, WorkRange range);
+
+// Vezme naposledy pridaný rozsah (volá len vlastník). Vráti 1, alebo 0, ak je deque prázdna.
+int work_deque_take(WorkDeque *deque, WorkRange *range);
+
+// Ukradne najstarší rozsah (volá iné vlákno). Vráti 1, 0 ak je deque prázdna,
+// -1 ak rozsah tesne predtým vzal niekto iný (oplatí sa skúsiť znova).
+int work_deque_steal(WorkDeque *deque, WorkRange *range);
+
+#endif // WORK_DEQUE_H